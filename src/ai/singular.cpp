@@ -1,5 +1,6 @@
 #include "singular.h"
 #include "pruning.h"
+#include "movegen.h"
 
 namespace {
     // Margin for considering a move singular (in centipawns)
@@ -31,14 +32,13 @@ bool is_singular(const Board& board, Move move, int depth, int alpha, int beta,
 
     // Verify move is indeed singular by searching alternatives
     int bestScore = -MATE_SCORE;
-    MoveList moves;
-    generate_moves(board, moves);
+    MoveList<> moves;
+    generate<LEGAL>(board, moves);
 
     for (const Move& m : moves) {
         if (m == move) continue;
 
-        Board b = board;
-        if (!b.make_move(m)) continue;
+        Board b = board.copy_make(m);
 
         int score = -search::alphaBeta<NonPV>(b, depth / 2, -reducedBeta, -reducedBeta + 1);
 
@@ -62,7 +62,8 @@ int extension_depth(const Board& board, Move move, int depth, int ttValue) {
     }
     
     // Reduce extension if move is from TT
-    if (move == TT.get_best_move(board.key())) {
+    TTData tt;
+    if (TT.probe(board.key(), tt) && move == tt.move) {
         extension -= 1;
     }
     
@@ -79,9 +80,9 @@ bool skip_move(const Board& board, Move move, int depth, int beta) {
         return false;
 
     // Check if this move failed high in previous verification
-    TTEntry* entry = TT.probe(board.key());
-    if (entry && entry->move == move && entry->bound == BOUND_LOWER) {
-        return entry->score >= beta;
+    TTData tt;
+    if (TT.probe(board.key(), tt) && tt.move == move && tt.bound == BOUND_LOWER) {
+        return tt.value >= beta;
     }
     
     return false;
@@ -0,0 +1,178 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include "bitboard.h"
+
+// Compile-time attack and geometry tables. Everything here is constexpr, so
+// the tables live in read-only pages shared between engine processes and
+// lookups on known squares fold away.
+namespace Attack {
+
+namespace detail {
+
+constexpr int abs_diff(int a, int b) { return a > b ? a - b : b - a; }
+
+// Square reached by a (file, rank) step, or SQ_NONE when it leaves the board
+constexpr Square step(Square s, int df, int dr) {
+    const int f = file_of(s) + df;
+    const int r = rank_of(s) + dr;
+    return f < 0 || f > 7 || r < 0 || r > 7 ? SQ_NONE : make_square(File(f), Rank(r));
+}
+
+template <std::size_t N>
+constexpr Bitboard leaper(Square s, const int (&steps)[N][2]) {
+    Bitboard b = 0;
+    for (const auto& st : steps) {
+        const Square to = step(s, st[0], st[1]);
+        if (to != SQ_NONE)
+            b |= square_bb(to);
+    }
+    return b;
+}
+
+constexpr int KnightSteps[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+constexpr int KingSteps[8][2]   = { {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1} };
+constexpr int PawnSteps[COLOR_NB][2][2] = { { {-1, 1}, {1, 1} }, { {-1, -1}, {1, -1} } };
+constexpr int RookSteps[4][2]   = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+constexpr int BishopSteps[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+} // namespace detail
+
+// Ray walk stopping at the first blocker; the reference for the magic tables
+constexpr Bitboard sliding_attacks(PieceType pt, Square s, Bitboard occ) {
+    Bitboard attacks = 0;
+    for (const auto& st : pt == ROOK ? detail::RookSteps : detail::BishopSteps) {
+        for (Square to = detail::step(s, st[0], st[1]); to != SQ_NONE; to = detail::step(to, st[0], st[1])) {
+            attacks |= square_bb(to);
+            if (occ & square_bb(to))
+                break;
+        }
+    }
+    return attacks;
+}
+
+constexpr int distance(Square a, Square b) {
+    const int df = detail::abs_diff(file_of(a), file_of(b));
+    const int dr = detail::abs_diff(rank_of(a), rank_of(b));
+    return df > dr ? df : dr;
+}
+
+inline constexpr std::array<Bitboard, SQUARE_NB> Knight = [] {
+    std::array<Bitboard, SQUARE_NB> t{};
+    for (Square s = SQ_A1; s <= SQ_H8; ++s)
+        t[s] = detail::leaper(s, detail::KnightSteps);
+    return t;
+}();
+
+inline constexpr std::array<Bitboard, SQUARE_NB> King = [] {
+    std::array<Bitboard, SQUARE_NB> t{};
+    for (Square s = SQ_A1; s <= SQ_H8; ++s)
+        t[s] = detail::leaper(s, detail::KingSteps);
+    return t;
+}();
+
+inline constexpr std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> Pawn = [] {
+    std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> t{};
+    for (Color c : { WHITE, BLACK })
+        for (Square s = SQ_A1; s <= SQ_H8; ++s)
+            t[c][s] = detail::leaper(s, detail::PawnSteps[c]);
+    return t;
+}();
+
+// Squares strictly between two aligned squares, 0 if not on a common line
+inline constexpr std::array<std::array<Bitboard, SQUARE_NB>, SQUARE_NB> Between = [] {
+    std::array<std::array<Bitboard, SQUARE_NB>, SQUARE_NB> t{};
+    for (PieceType pt : { BISHOP, ROOK })
+        for (Square a = SQ_A1; a <= SQ_H8; ++a)
+            for (Square b = SQ_A1; b <= SQ_H8; ++b)
+                if (sliding_attacks(pt, a, 0) & square_bb(b))
+                    t[a][b] = sliding_attacks(pt, a, square_bb(b)) & sliding_attacks(pt, b, square_bb(a));
+    return t;
+}();
+
+// Full edge-to-edge line through two aligned squares, 0 if not aligned
+inline constexpr std::array<std::array<Bitboard, SQUARE_NB>, SQUARE_NB> Line = [] {
+    std::array<std::array<Bitboard, SQUARE_NB>, SQUARE_NB> t{};
+    for (PieceType pt : { BISHOP, ROOK })
+        for (Square a = SQ_A1; a <= SQ_H8; ++a)
+            for (Square b = SQ_A1; b <= SQ_H8; ++b)
+                if (a != b && (sliding_attacks(pt, a, 0) & square_bb(b)))
+                    t[a][b] = (sliding_attacks(pt, a, 0) & sliding_attacks(pt, b, 0))
+                            | square_bb(a) | square_bb(b);
+    return t;
+}();
+
+// 3x3 box around the king, moved off the edge so it always holds 9 squares,
+// plus one extra rank towards the enemy
+inline constexpr std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> KingZone = [] {
+    std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> t{};
+    for (Color c : { WHITE, BLACK })
+        for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+            const int f = file_of(s) < FILE_B ? FILE_B : file_of(s) > FILE_G ? FILE_G : file_of(s);
+            const int r = rank_of(s) < RANK_2 ? RANK_2 : rank_of(s) > RANK_7 ? RANK_7 : rank_of(s);
+            const Square center = make_square(File(f), Rank(r));
+            const Bitboard box = detail::leaper(center, detail::KingSteps) | square_bb(center);
+            t[c][s] = box | (c == WHITE ? shift<NORTH>(box) : shift<SOUTH>(box));
+        }
+    return t;
+}();
+
+inline constexpr std::array<Bitboard, FILE_NB> AdjacentFiles = [] {
+    std::array<Bitboard, FILE_NB> t{};
+    for (File f = FILE_A; f <= FILE_H; ++f)
+        t[f] = shift<EAST>(file_bb(f)) | shift<WEST>(file_bb(f));
+    return t;
+}();
+
+// Squares in front of s on its own file
+inline constexpr std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> ForwardFile = [] {
+    std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> t{};
+    for (Color c : { WHITE, BLACK })
+        for (Square s = SQ_A1; s <= SQ_H8; ++s)
+            for (Square to = detail::step(s, 0, c == WHITE ? 1 : -1); to != SQ_NONE;
+                 to = detail::step(to, 0, c == WHITE ? 1 : -1))
+                t[c][s] |= square_bb(to);
+    return t;
+}();
+
+// Own and adjacent files in front of s: no enemy pawn here means s is passed
+inline constexpr std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> PassedPawnMask = [] {
+    std::array<std::array<Bitboard, SQUARE_NB>, COLOR_NB> t{};
+    for (Color c : { WHITE, BLACK })
+        for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+            Bitboard front = ForwardFile[c][s];
+            t[c][s] = front | shift<EAST>(front) | shift<WEST>(front);
+        }
+    return t;
+}();
+
+constexpr Bitboard knight(Square s) { return Knight[s]; }
+constexpr Bitboard king(Square s) { return King[s]; }
+constexpr Bitboard pawn_attacks(Color c, Square s) { return Pawn[c][s]; }
+constexpr Bitboard between(Square a, Square b) { return Between[a][b]; }
+constexpr Bitboard line(Square a, Square b) { return Line[a][b]; }
+constexpr bool aligned(Square a, Square b, Square c) { return Line[a][b] & square_bb(c); }
+constexpr Bitboard king_zone(Square s, Color c) { return KingZone[c][s]; }
+constexpr Bitboard king_zone(Square s) { return KingZone[WHITE][s] & KingZone[BLACK][s]; }
+constexpr Bitboard adjacent_files(File f) { return AdjacentFiles[f]; }
+constexpr Bitboard forward_file(Color c, Square s) { return ForwardFile[c][s]; }
+constexpr Bitboard passed_pawn_mask(Color c, Square s) { return PassedPawnMask[c][s]; }
+
+// Set-wise pawn attacks
+template <Color C>
+constexpr Bitboard pawn_attacks(Bitboard pawns) {
+    return C == WHITE ? shift<NORTH_WEST>(pawns) | shift<NORTH_EAST>(pawns)
+                      : shift<SOUTH_WEST>(pawns) | shift<SOUTH_EAST>(pawns);
+}
+
+constexpr Bitboard pawn_attacks_bb(Color c, Bitboard pawns) {
+    return c == WHITE ? pawn_attacks<WHITE>(pawns) : pawn_attacks<BLACK>(pawns);
+}
+
+// Compile-time sanity checks
+static_assert(knight(SQ_A1) == (square_bb(SQ_B3) | square_bb(SQ_C2)));
+static_assert(between(SQ_A1, SQ_D4) == (square_bb(SQ_B2) | square_bb(SQ_C3)));
+static_assert(between(SQ_A1, SQ_B3) == 0);
+static_assert(line(SQ_A1, SQ_A2) == FILE_A_BB);
+
+} // namespace Attack
@@ -0,0 +1,50 @@
+#pragma once
+#include "types.h"
+
+// File and rank masks
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_B_BB = FILE_A_BB << 1;
+constexpr Bitboard FILE_G_BB = FILE_A_BB << 6;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+constexpr Bitboard RANK_2_BB = RANK_1_BB << (8 * 1);
+constexpr Bitboard RANK_3_BB = RANK_1_BB << (8 * 2);
+constexpr Bitboard RANK_6_BB = RANK_1_BB << (8 * 5);
+constexpr Bitboard RANK_7_BB = RANK_1_BB << (8 * 6);
+constexpr Bitboard RANK_8_BB = RANK_1_BB << (8 * 7);
+
+constexpr Bitboard square_bb(Square s) { return 1ULL << s; }
+constexpr Bitboard file_bb(File f) { return FILE_A_BB << f; }
+constexpr Bitboard file_bb(Square s) { return file_bb(file_of(s)); }
+constexpr Bitboard rank_bb(Rank r) { return RANK_1_BB << (8 * r); }
+constexpr Bitboard rank_bb(Square s) { return rank_bb(rank_of(s)); }
+
+// Shift a bitboard one step in direction D without wrapping around the board edge
+template <Direction D>
+constexpr Bitboard shift(Bitboard b) {
+    return D == NORTH      ?  b << 8
+         : D == SOUTH      ?  b >> 8
+         : D == NORTH + NORTH ? b << 16
+         : D == SOUTH + SOUTH ? b >> 16
+         : D == EAST       ? (b & ~FILE_H_BB) << 1
+         : D == WEST       ? (b & ~FILE_A_BB) >> 1
+         : D == NORTH_EAST ? (b & ~FILE_H_BB) << 9
+         : D == NORTH_WEST ? (b & ~FILE_A_BB) << 7
+         : D == SOUTH_EAST ? (b & ~FILE_H_BB) >> 7
+         : D == SOUTH_WEST ? (b & ~FILE_A_BB) >> 9
+         : 0;
+}
+
+// Bit twiddling (GCC/Clang builtins)
+inline int popcount(Bitboard b) { return __builtin_popcountll(b); }
+inline Square lsb(Bitboard b) { return Square(__builtin_ctzll(b)); }
+inline Square msb(Bitboard b) { return Square(63 ^ __builtin_clzll(b)); }
+
+inline Square pop_lsb(Bitboard& b) {
+    const Square s = lsb(b);
+    b &= b - 1;
+    return s;
+}
+
+constexpr bool more_than_one(Bitboard b) { return b & (b - 1); }
@@ -1,30 +1,25 @@
 #include "board.h"
+#include "attack.h"
+#include "magic.h"
+#include "cuckoo.h"
+#include "movegen.h"
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <cstring>
 
-// Helper intrinsics - GCC/Clang built-in; replace if needed
-inline int bit_scan_forward(uint64_t bb) {
-    return __builtin_ctzll(bb);
-}
-
-// File masks for pawn attacks to avoid wrap-around
-constexpr uint64_t FILE_A = 0x0101010101010101ULL;
-constexpr uint64_t FILE_H = 0x8080808080808080ULL;
+namespace {
 
-// Precomputed attack arrays (You need to implement/fill these)
-extern uint64_t knight_attacks[64];
-extern uint64_t king_attacks[64];
-extern uint64_t between_bb[64][64];
+constexpr const char* StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr const char* PieceChars = " PNBRQK  pnbrqk";
 
-// Stub sliding attack functions (you must implement with magic bitboards or similar)
-uint64_t get_bishop_attacks(int sq, uint64_t occ) {
-    // TODO: Implement bishop attacks using occupancy 'occ'
-    return 0ULL;
+// Rights kept when a piece moves from or to a square
+constexpr uint8_t castling_mask(int sq) {
+    return sq == SQ_E1 ? 0b1100 : sq == SQ_H1 ? 0b1110 : sq == SQ_A1 ? 0b1101
+         : sq == SQ_E8 ? 0b0011 : sq == SQ_H8 ? 0b1011 : sq == SQ_A8 ? 0b0111 : 0b1111;
 }
 
-uint64_t get_rook_attacks(int sq, uint64_t occ) {
-    // TODO: Implement rook attacks using occupancy 'occ'
-    return 0ULL;
-}
+} // namespace
 
 // === Board class implementation ===
 
@@ -33,108 +28,476 @@ Board::Board() {
 }
 
 void Board::reset_board() {
-    // Starting position bitboards
-
-    pieces[WHITE][PAWN]   = 0x000000000000FF00ULL;
-    pieces[WHITE][KNIGHT] = 0x0000000000000042ULL;
-    pieces[WHITE][BISHOP] = 0x0000000000000024ULL;
-    pieces[WHITE][ROOK]   = 0x0000000000000081ULL;
-    pieces[WHITE][QUEEN]  = 0x0000000000000008ULL;
-    pieces[WHITE][KING]   = 0x0000000000000010ULL;
-
-    pieces[BLACK][PAWN]   = 0x00FF000000000000ULL;
-    pieces[BLACK][KNIGHT] = 0x4200000000000000ULL;
-    pieces[BLACK][BISHOP] = 0x2400000000000000ULL;
-    pieces[BLACK][ROOK]   = 0x8100000000000000ULL;
-    pieces[BLACK][QUEEN]  = 0x0800000000000000ULL;
-    pieces[BLACK][KING]   = 0x1000000000000000ULL;
-
-    castlingRights = 0b1111;  // KQkq allowed
-    enPassantSquare = -1;
-    halfmoveClock = 0;
-    fullmoveNumber = 1;
-    sideToMove = WHITE;
-
-    update_occupancy();
-
-    // Initialize Zobrist key
-    zobristKey = 0ULL;
-    for (Color c : {WHITE, BLACK}) {
-        for (PieceType pt = PAWN; pt <= KING; pt++) {
-            uint64_t bb = pieces[c][pt];
-            while (bb) {
-                int sq = bit_scan_forward(bb);
-                zobristKey ^= ZOBRIST_PIECE_KEYS[make_piece(c, pt)][sq];
-                bb &= bb - 1;
+    set_fen(StartFEN);
+}
+
+void Board::clear() {
+    std::memset(static_cast<void*>(this), 0, sizeof(Board));
+    st.epSquare = SQ_NONE;
+    st.fullmoveNumber = 1;
+}
+
+void Board::put_piece(Piece pc, Square s) {
+    board[s] = pc;
+    byType[type_of(pc) - PAWN] |= square_bb(s);
+    byColor[color_of(pc)] |= square_bb(s);
+}
+
+void Board::remove_piece(Square s) {
+    const Piece pc = board[s];
+    byType[type_of(pc) - PAWN] ^= square_bb(s);
+    byColor[color_of(pc)] ^= square_bb(s);
+    board[s] = NO_PIECE;
+}
+
+void Board::move_piece(Square from, Square to) {
+    const Piece pc = board[from];
+    const Bitboard fromTo = square_bb(from) | square_bb(to);
+    byType[type_of(pc) - PAWN] ^= fromTo;
+    byColor[color_of(pc)] ^= fromTo;
+    board[from] = NO_PIECE;
+    board[to] = pc;
+}
+
+bool Board::set_fen(const std::string& fen) {
+    Board b = *this;
+    b.clear();
+
+    std::istringstream ss(fen);
+    std::string placement, side, castling, ep;
+    int halfmove = 0, fullmove = 1;
+    if (!(ss >> placement >> side >> castling >> ep))
+        return false;
+    ss >> halfmove >> fullmove;
+
+    int rank = 7, file = 0;
+    for (char ch : placement) {
+        if (ch == '/') {
+            if (file != 8 || --rank < 0) return false;
+            file = 0;
+        } else if (ch >= '1' && ch <= '8') {
+            file += ch - '0';
+        } else {
+            const char* p = std::strchr(PieceChars, ch);
+            if (!p || ch == ' ' || file > 7) return false;
+            b.put_piece(Piece(p - PieceChars), make_square(File(file++), Rank(rank)));
+        }
+        if (file > 8) return false;
+    }
+    if (rank != 0 || file != 8)
+        return false;
+
+    if (side != "w" && side != "b") return false;
+    b.st.sideToMove = side == "w" ? WHITE : BLACK;
+
+    for (char ch : castling) {
+        switch (ch) {
+            case 'K': b.st.castlingRights |= 1; break;
+            case 'Q': b.st.castlingRights |= 2; break;
+            case 'k': b.st.castlingRights |= 4; break;
+            case 'q': b.st.castlingRights |= 8; break;
+            case '-': break;
+            default: return false;
+        }
+    }
+
+    if (ep != "-") {
+        if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h' || (ep[1] != '3' && ep[1] != '6'))
+            return false;
+        const Square s = make_square(File(ep[0] - 'a'), Rank(ep[1] - '1'));
+        // Only keep it if a pawn can actually capture, so equal positions hash equally
+        if (Attack::pawn_attacks(~b.st.sideToMove, s) & b.pieces(b.st.sideToMove, PAWN))
+            b.st.epSquare = uint8_t(s);
+    }
+
+    b.st.rule50 = uint8_t(std::clamp(halfmove, 0, 255));
+    b.st.fullmoveNumber = uint16_t(std::max(fullmove, 1));
+
+    if (!b.is_valid())
+        return false;
+
+    b.compute_keys(b.st);
+    *this = b;
+    return true;
+}
+
+std::string Board::to_fen() const {
+    std::ostringstream ss;
+    for (int rank = 7; rank >= 0; --rank) {
+        int emptyCount = 0;
+        for (int file = 0; file < 8; ++file) {
+            const Piece pc = board[rank * 8 + file];
+            if (pc == NO_PIECE) {
+                ++emptyCount;
+                continue;
             }
+            if (emptyCount) ss << emptyCount;
+            emptyCount = 0;
+            ss << PieceChars[pc];
         }
+        if (emptyCount) ss << emptyCount;
+        if (rank) ss << '/';
     }
-    if (sideToMove == BLACK) zobristKey ^= ZOBRIST_SIDE_KEY;
-    zobristKey ^= ZOBRIST_CASTLING_KEYS[castlingRights];
-    if (enPassantSquare != -1)
-        zobristKey ^= ZOBRIST_EP_KEYS[enPassantSquare % 8];
+
+    ss << (st.sideToMove == WHITE ? " w " : " b ");
+    if (st.castlingRights & 1) ss << 'K';
+    if (st.castlingRights & 2) ss << 'Q';
+    if (st.castlingRights & 4) ss << 'k';
+    if (st.castlingRights & 8) ss << 'q';
+    if (!st.castlingRights) ss << '-';
+
+    if (ep_square() == SQ_NONE)
+        ss << " -";
+    else
+        ss << ' ' << char('a' + file_of(ep_square())) << char('1' + rank_of(ep_square()));
+
+    ss << ' ' << int(st.rule50) << ' ' << st.fullmoveNumber;
+    return ss.str();
 }
 
-void Board::update_occupancy() {
-    occupancy[WHITE] = pieces[WHITE][PAWN] | pieces[WHITE][KNIGHT] | 
-                      pieces[WHITE][BISHOP] | pieces[WHITE][ROOK] | 
-                      pieces[WHITE][QUEEN] | pieces[WHITE][KING];
-    occupancy[BLACK] = pieces[BLACK][PAWN] | pieces[BLACK][KNIGHT] | 
-                      pieces[BLACK][BISHOP] | pieces[BLACK][ROOK] | 
-                      pieces[BLACK][QUEEN] | pieces[BLACK][KING];
-    occupancy[2] = occupancy[WHITE] | occupancy[BLACK];
+void Board::compute_keys(StateInfo& s) const {
+    s.key = s.pawnKey = s.materialKey = 0;
+    s.nonPawnKey[WHITE] = s.nonPawnKey[BLACK] = 0;
+
+    for (Square sq = SQ_A1; sq <= SQ_H8; ++sq) {
+        const Piece pc = board[sq];
+        if (pc == NO_PIECE)
+            continue;
+        s.key ^= ZOBRIST_PIECE_KEYS[pc][sq];
+        if (type_of(pc) == PAWN)
+            s.pawnKey ^= ZOBRIST_PIECE_KEYS[pc][sq];
+        else
+            s.nonPawnKey[color_of(pc)] ^= ZOBRIST_PIECE_KEYS[pc][sq];
+    }
+
+    // Material: one key per (piece, index among its kind), so only counts matter
+    for (Color c : { WHITE, BLACK })
+        for (PieceType pt = PAWN; pt <= KING; ++pt)
+            for (int i = 0; i < count(c, pt); ++i)
+                s.materialKey ^= ZOBRIST_PIECE_KEYS[make_piece(c, pt)][i];
+
+    if (s.sideToMove == WHITE) s.key ^= ZOBRIST_SIDE_KEY;
+    s.key ^= ZOBRIST_CASTLING_KEYS[s.castlingRights];
+    if (s.epSquare != SQ_NONE)
+        s.key ^= ZOBRIST_EP_KEYS[file_of(Square(s.epSquare))];
 }
 
-uint64_t Board::get_piece_bb(Color c, PieceType pt) const {
-    return pieces[c][pt];
+// Plays a legal move on the pieces and on st, whose 'previous' link the
+// caller has already set. Every key is updated incrementally.
+DirtyPiece Board::do_move(Move move) {
+    const Color us = st.sideToMove, them = ~us;
+    const Square from = Square(move.from()), to = Square(move.to());
+    const Piece pc = board[from];
+    DirtyPiece dp;
+    Key k = st.key ^ ZOBRIST_SIDE_KEY ^ ZOBRIST_CASTLING_KEYS[st.castlingRights];
+
+    dp.count = 1;
+    dp.piece[0] = pc;
+    dp.from[0] = from;
+    dp.to[0] = to;
+
+    st.move = move;
+    st.captured = NO_PIECE;
+    ++st.rule50;
+    ++st.pliesFromNull;
+
+    if (st.epSquare != SQ_NONE) {
+        k ^= ZOBRIST_EP_KEYS[file_of(Square(st.epSquare))];
+        st.epSquare = SQ_NONE;
+    }
+
+    if (move.is_castle()) {
+        // Encoded as the king's move; the rook jumps to the other side of it
+        const bool kingSide = to > from;
+        const Square rfrom = kingSide ? to + EAST : to + WEST + WEST;
+        const Square rto   = kingSide ? to + WEST : to + EAST;
+        const Piece rook = board[rfrom];
+        move_piece(from, to);
+        move_piece(rfrom, rto);
+
+        const Key delta = ZOBRIST_PIECE_KEYS[pc][from] ^ ZOBRIST_PIECE_KEYS[pc][to]
+                        ^ ZOBRIST_PIECE_KEYS[rook][rfrom] ^ ZOBRIST_PIECE_KEYS[rook][rto];
+        k ^= delta;
+        st.nonPawnKey[us] ^= delta;
+
+        dp.count = 2;
+        dp.piece[1] = rook;
+        dp.from[1] = rfrom;
+        dp.to[1] = rto;
+    } else {
+        const Square capsq = move.is_enpassant() ? to - pawn_push(us) : to;
+        const Piece captured = board[capsq];
+
+        if (captured != NO_PIECE) {
+            remove_piece(capsq);
+            k ^= ZOBRIST_PIECE_KEYS[captured][capsq];
+            if (type_of(captured) == PAWN)
+                st.pawnKey ^= ZOBRIST_PIECE_KEYS[captured][capsq];
+            else
+                st.nonPawnKey[them] ^= ZOBRIST_PIECE_KEYS[captured][capsq];
+            st.materialKey ^= ZOBRIST_PIECE_KEYS[captured][count(them, type_of(captured))];
+            st.captured = captured;
+            st.rule50 = 0;
+
+            dp.count = 2;
+            dp.piece[1] = captured;
+            dp.from[1] = capsq;
+            dp.to[1] = SQ_NONE;
+        }
+
+        move_piece(from, to);
+        const Key delta = ZOBRIST_PIECE_KEYS[pc][from] ^ ZOBRIST_PIECE_KEYS[pc][to];
+        k ^= delta;
+
+        if (type_of(pc) != PAWN)
+            st.nonPawnKey[us] ^= delta;
+        else {
+            st.pawnKey ^= delta;
+            st.rule50 = 0;
+
+            if (move.is_promotion()) {
+                const Piece promoted = make_piece(us, move.promotion_piece());
+                remove_piece(to);
+                st.materialKey ^= ZOBRIST_PIECE_KEYS[pc][count(us, PAWN)]
+                                ^ ZOBRIST_PIECE_KEYS[promoted][count(us, type_of(promoted))];
+                put_piece(promoted, to);
+                k ^= ZOBRIST_PIECE_KEYS[pc][to] ^ ZOBRIST_PIECE_KEYS[promoted][to];
+                st.pawnKey ^= ZOBRIST_PIECE_KEYS[pc][to];
+                st.nonPawnKey[us] ^= ZOBRIST_PIECE_KEYS[promoted][to];
+
+                // The pawn leaves the board and the new piece appears
+                dp.to[0] = SQ_NONE;
+                dp.piece[dp.count] = promoted;
+                dp.from[dp.count] = SQ_NONE;
+                dp.to[dp.count] = to;
+                ++dp.count;
+            } else if ((int(to) ^ int(from)) == 16
+                       && (Attack::pawn_attacks(us, to - pawn_push(us)) & pieces(them, PAWN))) {
+                st.epSquare = uint8_t(to - pawn_push(us));
+                k ^= ZOBRIST_EP_KEYS[file_of(to)];
+            }
+        }
+    }
+
+    st.castlingRights &= castling_mask(from) & castling_mask(to);
+    k ^= ZOBRIST_CASTLING_KEYS[st.castlingRights];
+
+    if (us == BLACK)
+        ++st.fullmoveNumber;
+    st.sideToMove = them;
+    st.key = k;
+    return dp;
 }
 
-uint64_t Board::get_occupancy(Color c) const {
-    return occupancy[c];
+Key Board::key_after(Move move) const {
+    const Square from = Square(move.from()), to = Square(move.to());
+    const Piece pc = board[from];
+    Key k = st.key ^ ZOBRIST_SIDE_KEY ^ ZOBRIST_PIECE_KEYS[pc][from];
+
+    if (st.epSquare != SQ_NONE)
+        k ^= ZOBRIST_EP_KEYS[file_of(Square(st.epSquare))];
+
+    if (move.is_castle()) {
+        const bool kingSide = to > from;
+        const Square rfrom = kingSide ? to + EAST : to + WEST + WEST;
+        const Square rto   = kingSide ? to + WEST : to + EAST;
+        k ^= ZOBRIST_PIECE_KEYS[board[rfrom]][rfrom] ^ ZOBRIST_PIECE_KEYS[board[rfrom]][rto];
+    } else {
+        const Square capsq = move.is_enpassant() ? to - pawn_push(st.sideToMove) : to;
+        if (board[capsq] != NO_PIECE)
+            k ^= ZOBRIST_PIECE_KEYS[board[capsq]][capsq];
+    }
+
+    const Piece placed = move.is_promotion() ? make_piece(st.sideToMove, move.promotion_piece()) : pc;
+    const uint8_t rights = st.castlingRights & castling_mask(from) & castling_mask(to);
+    return k ^ ZOBRIST_PIECE_KEYS[placed][to]
+             ^ ZOBRIST_CASTLING_KEYS[st.castlingRights] ^ ZOBRIST_CASTLING_KEYS[rights];
 }
 
-uint64_t Board::get_all_occupancy() const {
-    return occupancy[2];
+Key Board::pawn_key_after(Move move) const {
+    const Square from = Square(move.from()), to = Square(move.to());
+    const Piece pc = board[from];
+    Key k = st.pawnKey;
+
+    if (!move.is_castle()) {
+        const Square capsq = move.is_enpassant() ? to - pawn_push(st.sideToMove) : to;
+        if (type_of(board[capsq]) == PAWN)
+            k ^= ZOBRIST_PIECE_KEYS[board[capsq]][capsq];
+    }
+    if (type_of(pc) == PAWN)
+        k ^= ZOBRIST_PIECE_KEYS[pc][from] ^ (move.is_promotion() ? 0 : ZOBRIST_PIECE_KEYS[pc][to]);
+    return k;
 }
 
-int Board::square_index(int rank, int file) const {
-    return rank * 8 + file;
+DirtyPiece Board::make_move(Move move, StateInfo& undo) {
+    undo = st;
+    st.previous = &undo;
+    return do_move(move);
 }
 
-uint64_t Board::get_attacks_to(int square, Color attacker) const {
-    uint64_t attackers = 0ULL;
-    uint64_t target = 1ULL << square;
+// Reverses the last make_move: the pieces from st.move and st.captured, the
+// rest by restoring the saved record
+void Board::unmake_move() {
+    const Move move = st.move;
+    const Piece captured = st.captured;
+    st = *st.previous;
+
+    const Color us = st.sideToMove;
+    const Square from = Square(move.from()), to = Square(move.to());
+
+    if (move.is_castle()) {
+        const bool kingSide = to > from;
+        move_piece(to, from);
+        move_piece(kingSide ? to + WEST : to + EAST, kingSide ? to + EAST : to + WEST + WEST);
+        return;
+    }
 
-    // Pawns
-    uint64_t pawns = pieces[attacker][PAWN];
-    if (attacker == WHITE) {
-        attackers |= ((target >> 7) & ~FILE_H) | ((target >> 9) & ~FILE_A);
-    } else {
-        attackers |= ((target << 7) & ~FILE_A) | ((target << 9) & ~FILE_H);
+    if (move.is_promotion()) {
+        remove_piece(to);
+        put_piece(make_piece(us, PAWN), to);
+    }
+    move_piece(to, from);
+
+    if (captured != NO_PIECE)
+        put_piece(captured, move.is_enpassant() ? to - pawn_push(us) : to);
+}
+
+// Passes the turn, for null-move pruning. Never called in check.
+void Board::make_null_move(StateInfo& undo) {
+    undo = st;
+    st.previous = &undo;
+
+    st.key ^= ZOBRIST_SIDE_KEY;
+    if (st.epSquare != SQ_NONE) {
+        st.key ^= ZOBRIST_EP_KEYS[file_of(Square(st.epSquare))];
+        st.epSquare = SQ_NONE;
+    }
+    st.move = MOVE_NONE;
+    st.captured = NO_PIECE;
+    ++st.rule50;
+    st.pliesFromNull = 0;
+    if (st.sideToMove == BLACK)
+        ++st.fullmoveNumber;
+    st.sideToMove = ~st.sideToMove;
+}
+
+void Board::unmake_null_move() {
+    st = *st.previous;
+}
+
+namespace {
+
+// Scans back 2 plies at a time, never past the last capture, pawn move or
+// null move (nothing before it can repeat), nor past the start of the
+// history. Calls f(plies back, state) until it returns true.
+template <typename F>
+bool scan_history(const StateInfo& st, int firstPly, F&& f) {
+    const int end = std::min<int>(st.rule50, st.pliesFromNull);
+    const StateInfo* stp = st.previous;
+    for (int i = 1; i < firstPly && stp; ++i)
+        stp = stp->previous;
+
+    for (int i = firstPly; i <= end && stp; i += 2) {
+        if (f(i, *stp))
+            return true;
+        stp = stp->previous ? stp->previous->previous : nullptr;
     }
-    attackers &= pawns;
+    return false;
+}
+
+bool repeated_before(const StateInfo& st) {
+    return scan_history(st, 4, [&](int, const StateInfo& s) { return s.key == st.key; });
+}
+
+} // namespace
+
+bool Board::is_draw(int ply) const {
+    // Mate on the hundredth ply still wins
+    if (st.rule50 > 99) {
+        if (!in_check())
+            return true;
+        MoveList<> evasions;
+        generate<EVASIONS>(*this, evasions);
+        if (evasions.size())
+            return true;
+    }
+    return is_repetition(ply);
+}
+
+bool Board::is_repetition(int ply) const {
+    int count = 0;
+    return scan_history(st, 4, [&](int i, const StateInfo& s) {
+        return s.key == st.key && (i < ply || ++count == 2);
+    });
+}
 
-    // Knights
-    attackers |= knight_attacks[square] & pieces[attacker][KNIGHT];
+// The cuckoo test: does one reversible move lead from here to a position an
+// odd number of plies back? Lets the search score a draw one ply before the
+// repetition is on the board.
+bool Board::has_game_cycle(int ply) const {
+    return scan_history(st, 3, [&](int i, const StateInfo& s) {
+        const int slot = Cuckoo::find(st.key ^ s.key);
+        if (slot < 0)
+            return false;
+
+        // The path must be clear for the move to be playable
+        const Move move = Cuckoo::move(slot);
+        const Square s1 = Square(move.from()), s2 = Square(move.to());
+        if (Attack::between(s1, s2) & pieces())
+            return false;
+
+        if (ply > i)
+            return true;
+
+        // Before the root the move must be ours (the table stores both
+        // directions in one slot) and the position must already repeat
+        return color_on(empty(s1) ? s2 : s1) == st.sideToMove && repeated_before(s);
+    });
+}
 
-    // Bishops and Queens (diagonals)
-    attackers |= get_bishop_attacks(square, occupancy[2]) & 
-                 (pieces[attacker][BISHOP] | pieces[attacker][QUEEN]);
+Board Board::copy_make(Move move) const {
+    Board next = *this;
+    next.st.previous = &st;
+    next.do_move(move);
+    return next;
+}
 
-    // Rooks and Queens (straight)
-    attackers |= get_rook_attacks(square, occupancy[2]) & 
-                 (pieces[attacker][ROOK] | pieces[attacker][QUEEN]);
+template <Color Attacker>
+uint64_t Board::attacks_to(int square) const {
+    const Square s = Square(square);
+    const Bitboard occ = pieces();
+
+    return ((Attack::pawn_attacks(~Attacker, s) & pieces(Attacker, PAWN))
+          | (Attack::knight(s) & pieces(KNIGHT))
+          | (get_bishop_attacks(square, occ) & (pieces(BISHOP) | pieces(QUEEN)))
+          | (get_rook_attacks(square, occ) & (pieces(ROOK) | pieces(QUEEN)))
+          | (Attack::king(s) & pieces(KING)))
+         & pieces(Attacker);
+}
 
-    // King
-    attackers |= king_attacks[square] & pieces[attacker][KING];
+template uint64_t Board::attacks_to<WHITE>(int) const;
+template uint64_t Board::attacks_to<BLACK>(int) const;
+
+uint64_t Board::get_attacks_to(int square, Color attacker) const {
+    return attacker == WHITE ? attacks_to<WHITE>(square) : attacks_to<BLACK>(square);
+}
 
-    return attackers;
+uint64_t Board::attackers_to(int square, uint64_t occ) const {
+    const Square s = Square(square);
+    return (Attack::pawn_attacks(BLACK, s) & pieces(WHITE, PAWN))
+         | (Attack::pawn_attacks(WHITE, s) & pieces(BLACK, PAWN))
+         | (Attack::knight(s) & pieces(KNIGHT))
+         | (get_bishop_attacks(square, occ) & (pieces(BISHOP) | pieces(QUEEN)))
+         | (get_rook_attacks(square, occ) & (pieces(ROOK) | pieces(QUEEN)))
+         | (Attack::king(s) & pieces(KING));
 }
 
 uint64_t Board::get_checkers() const {
-    // TODO: Implement: find pieces checking the king of sideToMove
-    // Stub for now:
-    return 0ULL;
+    return get_attacks_to(king_square(st.sideToMove), ~st.sideToMove);
+}
+
+bool Board::is_capture(Move move) const {
+    return (!empty(move.to()) && !move.is_castle()) || move.is_enpassant();
 }
 
 bool Board::is_square_attacked(int square, Color by_color) const {
@@ -142,57 +505,210 @@ bool Board::is_square_attacked(int square, Color by_color) const {
 }
 
 uint64_t Board::pinned_pieces(Color c) const {
-    uint64_t pinned = 0ULL;
-    int king_sq = bit_scan_forward(pieces[c][KING]);
-    uint64_t sliders = pieces[!c][BISHOP] | pieces[!c][ROOK] | pieces[!c][QUEEN];
+    uint64_t pinners;
+    return slider_blockers(pieces(~c), king_square(c), pinners) & pieces(c);
+}
 
-    while (sliders) {
-        int sq = bit_scan_forward(sliders);
-        uint64_t between = between_bb[sq][king_sq] & occupancy[2];
-        if (__builtin_popcountll(between) == 1) pinned |= between;
-        sliders &= sliders - 1;
+// Pieces of either color standing alone between 'square' and one of the
+// given sliders. 'pinners' receives the sliders behind such a blocker.
+uint64_t Board::slider_blockers(uint64_t sliders, int square, uint64_t& pinners) const {
+    const Square s = Square(square);
+    uint64_t blockers = 0ULL;
+    pinners = 0ULL;
+
+    // Only sliders that could attack the square on an empty board matter
+    uint64_t snipers = ((get_rook_attacks(s, 0) & (pieces(ROOK) | pieces(QUEEN)))
+                      | (get_bishop_attacks(s, 0) & (pieces(BISHOP) | pieces(QUEEN)))) & sliders;
+
+    while (snipers) {
+        const Square sniper = pop_lsb(snipers);
+        const Bitboard between = Attack::between(s, sniper) & pieces();
+        if (between && !more_than_one(between)) {
+            blockers |= between;
+            pinners |= square_bb(sniper);
+        }
     }
-    return pinned & occupancy[c];
+    return blockers;
 }
 
-bool Board::is_legal(Move move) const {
-    // TODO: Implement legality check including king safety, en passant, pins
-    // Stub always returns true for now:
-    return true;
+CheckInfo::CheckInfo(const Board& pos) {
+    const Color us = pos.side_to_move(), them = ~us;
+    const Bitboard occ = pos.pieces();
+    ksq = pos.king_square(them);
+
+    checkSquares[NONE]   = 0;
+    checkSquares[PAWN]   = Attack::pawn_attacks(them, ksq);
+    checkSquares[KNIGHT] = Attack::knight(ksq);
+    checkSquares[BISHOP] = get_bishop_attacks(ksq, occ);
+    checkSquares[ROOK]   = get_rook_attacks(ksq, occ);
+    checkSquares[QUEEN]  = checkSquares[BISHOP] | checkSquares[ROOK];
+    checkSquares[KING]   = 0;
+
+    Bitboard ourSnipers;
+    dcCandidates = pos.slider_blockers(pos.pieces(us), ksq, ourSnipers) & pos.pieces(us);
+    pinned = pos.slider_blockers(pos.pieces(them), pos.king_square(us), pinners) & pos.pieces(us);
 }
 
-bool Board::is_valid() const {
-    // Basic sanity check (one king per side, no pawns on ranks 1 or 8, etc.)
-    int white_kings = __builtin_popcountll(pieces[WHITE][KING]);
-    int black_kings = __builtin_popcountll(pieces[BLACK][KING]);
+// Direct checks come from the precomputed squares, discovered ones from the
+// candidates; only promotions, en passant and castling look any further.
+bool Board::gives_check(Move move, const CheckInfo& ci) const {
+    const Color us = st.sideToMove;
+    const Square from = Square(move.from()), to = Square(move.to());
+
+    if (ci.checkSquares[type_of(board[from])] & square_bb(to))
+        return true;
+
+    if ((ci.dcCandidates & square_bb(from)) && !Attack::aligned(from, to, ci.ksq))
+        return true;
+
+    switch (move.type()) {
+    case Move::NORMAL:
+        return false;
+
+    case Move::PROMOTION: {
+        const Bitboard occ = pieces() ^ square_bb(from);
+        const PieceType pt = move.promotion_piece();
+        const Bitboard attacks = pt == KNIGHT ? Attack::knight(to)
+                               : pt == BISHOP ? get_bishop_attacks(to, occ)
+                               : pt == ROOK   ? get_rook_attacks(to, occ)
+                               :                get_queen_attacks(to, occ);
+        return attacks & square_bb(ci.ksq);
+    }
+
+    // Two pawns leave their squares, which may open a line on the king
+    case Move::EN_PASSANT: {
+        const Square capsq = to - pawn_push(us);
+        const Bitboard occ = (pieces() ^ square_bb(from) ^ square_bb(capsq)) | square_bb(to);
+        return (get_rook_attacks(ci.ksq, occ) & pieces(us, ROOK, QUEEN))
+             | (get_bishop_attacks(ci.ksq, occ) & pieces(us, BISHOP, QUEEN));
+    }
+
+    // Castling: only the rook can give a direct check
+    default: {
+        const Square rto = to > from ? to + WEST : to + EAST;
+        return ci.checkSquares[ROOK] & square_bb(rto);
+    }
+    }
+}
+
+// Cheap validation of a move from outside this position (TT, killers,
+// countermoves), so a hash collision cannot play garbage. Leaving the king
+// in check is is_legal's job.
+bool Board::pseudo_legal(Move move) const {
+    const Color us = st.sideToMove;
+    const Square from = Square(move.from()), to = Square(move.to());
+    const Piece pc = board[from];
+
+    if (!move.is_valid() || pc == NO_PIECE || color_of(pc) != us || (pieces(us) & square_bb(to)))
+        return false;
+
+    // Only promotions carry a promotion piece; a stray one is a collision
+    if (!move.is_promotion() && (move.raw() & 0x3000))
+        return false;
+
+    const Bitboard occ = pieces();
+
+    switch (move.type()) {
+    case Move::CASTLING: {
+        const bool kingSide = to > from;
+        const uint8_t right = (us == WHITE ? 1 : 4) << (kingSide ? 0 : 1);
+        const Square rfrom = relative_square(us, kingSide ? SQ_H1 : SQ_A1);
+        return from == relative_square(us, SQ_E1)
+            && to == relative_square(us, kingSide ? SQ_G1 : SQ_C1)
+            && type_of(pc) == KING && (st.castlingRights & right)
+            && board[rfrom] == make_piece(us, ROOK)
+            && !(Attack::between(from, rfrom) & occ);
+    }
+
+    case Move::EN_PASSANT:
+        return type_of(pc) == PAWN && to == ep_square()
+            && (Attack::pawn_attacks(us, from) & square_bb(to));
+
+    default:
+        break;
+    }
+
+    if (type_of(pc) != PAWN)
+        return !move.is_promotion()
+            && ((type_of(pc) == KNIGHT ? Attack::knight(from)
+               : type_of(pc) == BISHOP ? get_bishop_attacks(from, occ)
+               : type_of(pc) == ROOK   ? get_rook_attacks(from, occ)
+               : type_of(pc) == QUEEN  ? get_queen_attacks(from, occ)
+               :                         Attack::king(from)) & square_bb(to));
+
+    // Pawns promote exactly when they reach the last rank
+    if (move.is_promotion() != (relative_rank(us, to) == RANK_8))
+        return false;
+
+    const Square push = from + pawn_push(us);
+    return (Attack::pawn_attacks(us, from) & pieces(~us) & square_bb(to))
+        || (to == push && !(occ & square_bb(to)))
+        || (to == push + pawn_push(us) && relative_rank(us, from) == RANK_2
+            && !(occ & (square_bb(push) | square_bb(to))));
+}
+
+// Full check for a pseudo-legal move, e.g. a TT or killer move. Generated
+// moves are already legal and never need this.
+bool Board::is_legal(Move move) const {
+    const Color us = st.sideToMove;
+    const Color them = ~us;
+    const int from = move.from();
+    const int to = move.to();
+    const Square king_sq = king_square(us);
+    const uint64_t fromBB = 1ULL << from, toBB = 1ULL << to;
+
+    // En passant and king moves: recompute attacks on the resulting occupancy
+    if (move.is_enpassant()) {
+        const int capsq = to + (us == WHITE ? -8 : 8);
+        const uint64_t occ = (pieces() ^ fromBB ^ (1ULL << capsq)) | toBB;
+        return !(attackers_to(king_sq, occ) & pieces(them) & ~(1ULL << capsq));
+    }
+
+    if (from == king_sq) {
+        if (move.is_castle()) {
+            if (get_checkers())
+                return false;
+            const int step = to > from ? 1 : -1;
+            for (int s = from + step; s != to + step; s += step)
+                if (is_square_attacked(s, them))
+                    return false;
+            return true;
+        }
+        return !(attackers_to(to, pieces() ^ fromBB) & pieces(them) & ~toBB);
+    }
 
-    if (white_kings != 1 || black_kings != 1) return false;
+    // Other pieces: must resolve any check and stay on a pin ray
+    const uint64_t checkers = get_checkers();
+    if (checkers) {
+        if (more_than_one(checkers))
+            return false;
+        if (!(toBB & (Attack::between(king_sq, lsb(checkers)) | checkers)))
+            return false;
+    }
 
-    uint64_t pawns = pieces[WHITE][PAWN] | pieces[BLACK][PAWN];
-    if (pawns & (0xFFULL | (0xFFULL << 56))) return false;  // Pawns on first or last rank
+    return !(pinned_pieces(us) & fromBB) || Attack::aligned(Square(from), Square(to), king_sq);
+}
 
+bool Board::is_valid() const {
+    // Basic sanity check (one king per side, no pawns on ranks 1 or 8, etc.)
+    if (count(WHITE, KING) != 1 || count(BLACK, KING) != 1) return false;
+    if (pieces(PAWN) & (RANK_1_BB | RANK_8_BB)) return false;  // Pawns on first or last rank
+
+    // Mailbox and bitboards must agree
+    for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+        const Piece pc = board[s];
+        if (pc == NO_PIECE ? bool(pieces() & square_bb(s))
+                           : !(pieces(color_of(pc), type_of(pc)) & square_bb(s)))
+            return false;
+    }
     return true;
 }
 
 void Board::print() const {
-    const char piece_chars[12] = { 'P','N','B','R','Q','K','p','n','b','r','q','k' };
-
     for (int rank = 7; rank >= 0; --rank) {
         for (int file = 0; file < 8; ++file) {
-            int sq = rank * 8 + file;
-            bool found = false;
-            for (Color c : {WHITE, BLACK}) {
-                for (int pt = PAWN; pt <= KING; ++pt) {
-                    if (pieces[c][pt] & (1ULL << sq)) {
-                        int idx = pt + (c == BLACK ? 6 : 0);
-                        std::cout << piece_chars[idx];
-                        found = true;
-                        break;
-                    }
-                }
-                if (found) break;
-            }
-            if (!found) std::cout << '.';
+            const Piece pc = board[rank * 8 + file];
+            std::cout << (pc == NO_PIECE ? '.' : PieceChars[pc]);
         }
         std::cout << "\n";
     }
@@ -1,62 +1,159 @@
 #pragma once
 #include <cstdint>
-#include <array>
-#include <vector>
 #include <string>
+#include <type_traits>
 
-#include "move.h"       // Assume you have a Move class/struct defined elsewhere
+#include "types.h"
+#include "bitboard.h"
+#include "move.h"
 #include "zobrist.h"    // For Zobrist hashing keys and functions
 
-enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NONE };
-enum Color { WHITE, BLACK, COLOR_NONE };
+// Everything make_move cannot recompute cheaply from the pieces. The Board
+// keeps the current one inline; make_move saves it into a caller-owned record
+// (usually on the search stack) and unmake_move copies it back, so the chain
+// of previous records doubles as the game history for repetition checks.
+struct StateInfo {
+    Key key;                      // Zobrist key of the whole position
+    Key pawnKey;                  // Pawns only, for the pawn hash
+    Key materialKey;              // Piece counts, for material/endgame tables
+    Key nonPawnKey[COLOR_NB];     // Non-pawn pieces (incl. king) per color
+    const StateInfo* previous;    // Record of the position before, nullptr at the root
+    Move move;                    // Move that reached this position
+    Piece captured;               // Piece it captured, NO_PIECE if none
+    uint8_t epSquare;             // Square, SQ_NONE if none
+    uint8_t castlingRights;       // Bits: K=1, Q=2, k=4, q=8
+    uint8_t rule50;               // Plies since the last capture or pawn move
+    uint8_t pliesFromNull;        // Plies since the last null move
+    Color sideToMove;
+    uint16_t fullmoveNumber;      // Starts at 1
+};
+
+// Pieces a move added, removed or relocated, so NNUE accumulators, PST scores
+// and the pawn hash can update without rescanning the board
+struct DirtyPiece {
+    int count;                    // 1 quiet, 2 capture/castling/promotion, 3 capture-promotion
+    Piece piece[3];
+    Square from[3];               // SQ_NONE: the piece appears (promotion)
+    Square to[3];                 // SQ_NONE: the piece leaves the board (capture)
+};
+
+class Board;
+
+// What the side to move needs to know to tell whether a move gives check.
+// Built once per node; gives_check and quiet-check generation then cost a
+// couple of ANDs per move instead of a make/test/unmake.
+struct CheckInfo {
+    explicit CheckInfo(const Board& pos);
+
+    Square ksq;                            // Their king
+    Bitboard checkSquares[PIECE_TYPE_NB];  // Where each of our piece types would give check
+    Bitboard dcCandidates;                 // Our pieces whose move may uncover a slider check
+    Bitboard pinned;                       // Our pieces pinned to our own king
+    Bitboard pinners;                      // Their sliders doing the pinning
+};
 
+// Position representation: bitboards by piece type and by color, plus a
+// mailbox for "what is on this square". No heap members, so a Board can be
+// copied with memcpy (copy-make) as cheaply as it is updated in place.
 class Board {
 public:
     Board();
 
-    // Bitboards for each piece type by color: [color][piecetype]
-    std::array<std::array<uint64_t, 6>, 2> pieces;  // [color][piece]
+    // Basic board setup and utility functions
+    void reset_board();
+    bool set_fen(const std::string& fen);   // False (and board unchanged) on malformed FEN
+    std::string to_fen() const;             // Export board to FEN string
 
-    // Occupancy bitboards for white, black, and both sides
-    uint64_t occupancy[3];  // 0 = WHITE, 1 = BLACK, 2 = BOTH
+    // Piece access
+    Bitboard pieces() const { return byColor[WHITE] | byColor[BLACK]; }
+    Bitboard pieces(Color c) const { return byColor[c]; }
+    Bitboard pieces(PieceType pt) const { return pt == ALL_PIECES ? pieces() : byType[pt - PAWN]; }
+    Bitboard pieces(Color c, PieceType pt) const { return byColor[c] & pieces(pt); }
+    Bitboard pieces(Color c, PieceType pt1, PieceType pt2) const { return pieces(c, pt1) | pieces(c, pt2); }
+    Piece piece_on(int sq) const { return board[sq]; }
+    Color color_on(int sq) const { return color_of(board[sq]); }  // Only for occupied squares
+    bool empty(int sq) const { return board[sq] == NO_PIECE; }
+    int count(Color c, PieceType pt) const { return popcount(pieces(c, pt)); }
+    int piece_count() const { return popcount(pieces()); }
+    Square king_square(Color c) const { return lsb(pieces(c, KING)); }
 
-    // Current game state
-    Color sideToMove;
-    uint8_t castlingRights;  // Bits: K=1, Q=2, k=4, q=8 (0b1111 = all allowed)
-    int enPassantSquare;     // Square index 0-63 or -1 if none
-    int halfmoveClock;       // For 50-move rule
-    int fullmoveNumber;      // Starts at 1
+    // Game state
+    Color side_to_move() const { return st.sideToMove; }
+    uint8_t castling_rights() const { return st.castlingRights; }  // Bits: K=1, Q=2, k=4, q=8
+    Square ep_square() const { return Square(st.epSquare); }       // SQ_NONE if none
+    int rule50() const { return st.rule50; }
+    int plies_from_null() const { return st.pliesFromNull; }
+    int fullmove_number() const { return st.fullmoveNumber; }
+    Key key() const { return st.key; }
+    Key pawn_key() const { return st.pawnKey; }
+    Key material_key() const { return st.materialKey; }
+    Key non_pawn_key(Color c) const { return st.nonPawnKey[c]; }
+    Move last_move() const { return st.move; }
+    Piece captured_piece() const { return st.captured; }
+    const StateInfo* state() const { return &st; }
 
-    // Zobrist hash key of current position
-    uint64_t zobristKey;
+    // Make/unmake: 'undo' receives the current state and must outlive the
+    // move (keep it on the caller's stack). Returns what changed on the board.
+    DirtyPiece make_move(Move move, StateInfo& undo);
+    void unmake_move();
+    void make_null_move(StateInfo& undo);
+    void unmake_null_move();
 
-    // Basic board setup and utility functions
-    void reset_board();
-    uint64_t get_piece_bb(Color c, PieceType pt) const;
-    uint64_t get_occupancy(Color c) const;
-    uint64_t get_all_occupancy() const;
-    int square_index(int rank, int file) const;
+    // Draw detection over the StateInfo chain, which is each search thread's
+    // own key history. 'ply' is the distance from the search root: a
+    // repetition inside the tree counts at once, one before the root must
+    // have occurred twice.
+    bool is_draw(int ply) const;                // Fifty-move rule or repetition
+    bool is_repetition(int ply) const;
+    bool has_game_cycle(int ply) const;         // Some move repeats an earlier position
+
+    // Keys of the position after a legal move, without making it, so the
+    // search can prefetch the child's TT cluster and pawn hash slot while
+    // make_move runs. Exact except for an en passant square the move creates.
+    Key key_after(Move move) const;
+    Key pawn_key_after(Move move) const;
+
+    // Copy-make: the position after a legal move, leaving this one untouched.
+    // The copy links back to this board's state, which must stay alive.
+    Board copy_make(Move move) const;
 
     // Move generation helpers
     uint64_t get_attacks_to(int square, Color attacker) const;  // Pieces attacking given square
+    template <Color Attacker>
+    uint64_t attacks_to(int square) const;                      // Same, attacker fixed at compile time
+    uint64_t attackers_to(int square, uint64_t occ) const;     // Both colors, custom occupancy (x-rays)
     uint64_t get_checkers() const;                              // Bitboard of pieces checking the king
+    bool in_check() const { return get_checkers() != 0; }
+    bool is_capture(Move move) const;                           // Captures taken from the board, not the move
     bool is_square_attacked(int square, Color by_color) const; // Is square attacked by side?
 
-    // Pin and legality
+    // Pins, checks and legality
     uint64_t pinned_pieces(Color c) const;                      // Pieces pinned to king
-    bool is_legal(Move move) const;                             // Does move leave king safe?
+    uint64_t slider_blockers(uint64_t sliders, int square, uint64_t& pinners) const;  // Lone pieces between
+    bool gives_check(Move move, const CheckInfo& ci) const;     // Legal move checks the opponent?
+    bool pseudo_legal(Move move) const;                         // Could be generated here, ignoring checks?
+    bool is_legal(Move move) const;                             // Pseudo-legal move leaves king safe?
 
     // Validation and integrity checks
     bool is_valid() const;  // Sanity checks: exactly one king, no pawns on rank 1/8, etc.
 
     // Debug and output
     void print() const;                  // ASCII board representation
-    std::string to_fen() const;          // Export board to FEN string
 
 private:
-    void update_occupancy();             // Update occupancy arrays from piece bitboards
-    void update_zobrist_key(Move move); // Incremental Zobrist hash update on move
+    void clear();
+    void put_piece(Piece pc, Square s);
+    void remove_piece(Square s);
+    void move_piece(Square from, Square to);
+    DirtyPiece do_move(Move move);       // Updates pieces and st, keys incrementally
+    void compute_keys(StateInfo& s) const;  // Full recomputation (setup and validation)
 
-    // Optional optimizations
-    std::array<std::vector<int>, 2> pieceLists;  // Lists of squares occupied by each color's pieces
+    Bitboard byType[6];                  // [pt - PAWN]
+    Bitboard byColor[COLOR_NB];
+    Piece board[SQUARE_NB];              // Mailbox
+    StateInfo st;                        // Current state
 };
+
+static_assert(std::is_trivially_copyable<Board>::value, "Board must stay memcpy-able for copy-make");
+static_assert(sizeof(StateInfo) <= 64, "StateInfo should fit in a cache line");
+static_assert(sizeof(Board) <= 192, "Board should fit in three cache lines");
@@ -82,9 +82,8 @@ bool Book::load_polyglot(const std::string& filename) {
         bookMap[key].emplace_back(BookEntry{ move, weight, learn });
     }
 
-    // Basic sanity check
-    const uint64_t TEST_KEY = 0x463b96181691fc9cULL; // Start position key (Polyglot)
-    if (bookMap.find(TEST_KEY) == bookMap.end()) {
+    // Basic sanity check (our keys are Polyglot's, see zobrist.h)
+    if (bookMap.find(Zobrist::PolyglotStartKey) == bookMap.end()) {
         std::cerr << "WARNING: Book may be corrupt or empty\n";
     }
 
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <shared_mutex>
 #include "move.h"
+#include "board.h"
 
 enum class BookPolicy {
     UNIFORM,
@@ -36,6 +37,13 @@ public:
 
     bool get_move(uint64_t zobristKey, Move& outMove, BookPolicy policy = BookPolicy::WEIGHTED) const;
 
+    // Board keys are Polyglot-shaped and kept incrementally, so a probe is
+    // one lookup with no rehash of the position
+    std::vector<BookEntry> get_moves(const Board& pos) const { return get_moves(pos.key()); }
+    bool get_move(const Board& pos, Move& outMove, BookPolicy policy = BookPolicy::WEIGHTED) const {
+        return get_move(pos.key(), outMove, policy);
+    }
+
     bool is_opening_phase(uint64_t zobristKey) const;
 
     size_t size() const { return bookMap.size(); }
@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include "types.h"
+#include "move.h"
+#include "attack.h"
+#include "zobrist.h"
+
+// Cuckoo tables of the key change made by every reversible move (a non-pawn
+// piece going from one square to another, side to move flipped), generated
+// at compile time. If the key difference between the current position and
+// one an odd number of plies back is in the table, a single move can reach
+// that earlier position: a repetition is one ply away.
+// Kenji Hasegawa's method, as used by Stockfish.
+namespace Cuckoo {
+
+constexpr int Size = 8192;
+
+constexpr int h1(Key k) { return int(k & 0x1FFF); }
+constexpr int h2(Key k) { return int((k >> 16) & 0x1FFF); }
+
+struct Table {
+    std::array<Key, Size> keys{};
+    std::array<Move, Size> moves{};
+    int count = 0;
+};
+
+inline constexpr Table Tables = [] {
+    Table t{};
+    for (Piece pc : { W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+                      B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING })
+        for (Square s1 = SQ_A1; s1 <= SQ_H8; ++s1) {
+            const PieceType pt = type_of(pc);
+            const Bitboard attacks = pt == KNIGHT ? Attack::knight(s1)
+                                   : pt == KING   ? Attack::king(s1)
+                                   : pt == BISHOP ? Attack::sliding_attacks(BISHOP, s1, 0)
+                                   : pt == ROOK   ? Attack::sliding_attacks(ROOK, s1, 0)
+                                   : Attack::sliding_attacks(BISHOP, s1, 0) | Attack::sliding_attacks(ROOK, s1, 0);
+
+            for (Square s2 = Square(s1 + 1); s2 <= SQ_H8; ++s2) {
+                if (!(attacks & square_bb(s2)))
+                    continue;
+
+                // Insert, evicting into the other slot until a free one is found
+                Move move(s1, s2);
+                Key key = ZOBRIST_PIECE_KEYS[pc][s1] ^ ZOBRIST_PIECE_KEYS[pc][s2] ^ ZOBRIST_SIDE_KEY;
+                int i = h1(key);
+                while (true) {
+                    const Key k = t.keys[i]; t.keys[i] = key; key = k;
+                    const Move m = t.moves[i]; t.moves[i] = move; move = m;
+                    if (move == Move::none())
+                        break;
+                    i = i == h1(key) ? h2(key) : h1(key);
+                }
+                ++t.count;
+            }
+        }
+    return t;
+}();
+
+static_assert(Tables.count == 3668, "Every reversible move must be in the cuckoo table");
+
+// Slot holding 'moveKey', or -1
+constexpr int find(Key moveKey) {
+    return Tables.keys[h1(moveKey)] == moveKey ? h1(moveKey)
+         : Tables.keys[h2(moveKey)] == moveKey ? h2(moveKey) : -1;
+}
+
+constexpr Move move(int slot) { return Tables.moves[slot]; }
+
+} // namespace Cuckoo
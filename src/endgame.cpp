@@ -48,16 +48,16 @@ EndgameTablebase::ProbeResult EndgameTablebase::probe(const Board& pos) const {
         return result;
 
     // Convert to Fathom's expected format
-    uint64_t white = pos.pieces[WHITE][ALL_PIECES];
-    uint64_t black = pos.pieces[BLACK][ALL_PIECES];
-    uint64_t kings = pos.pieces[WHITE][KING] | pos.pieces[BLACK][KING];
-    uint64_t queens = pos.pieces[WHITE][QUEEN] | pos.pieces[BLACK][QUEEN];
+    uint64_t white = pos.pieces(WHITE);
+    uint64_t black = pos.pieces(BLACK);
+    uint64_t kings = pos.pieces(KING);
+    uint64_t queens = pos.pieces(QUEEN);
     // ... similarly for other pieces
 
     unsigned tb_result;
     uint16_t move = tb_probe_root(
         white, black, kings, queens, /*rooks*/, /*bishops*/, /*knights*/, /*pawns*/,
-        pos.sideToMove == WHITE,
+        pos.side_to_move() == WHITE,
         &tb_result
     );
 
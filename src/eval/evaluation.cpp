@@ -109,21 +109,26 @@ Score evaluate(const Board& board, EvalInfo* info) {
     return board.side_to_move() == WHITE ? classical : -classical;
 }
 
+namespace {
+
+// Per-color piece loop: the table row and the mobility slot are fixed at
+// compile time instead of being looked up from each piece's square.
+template <Color Us>
 Score evaluate_pieces(const Board& board, EvalInfo& info, Phase ph) {
     Score score = SCORE_ZERO;
     
     // Evaluate each piece type
     for (PieceType pt = KNIGHT; pt <= QUEEN; ++pt) {
-        Bitboard pieces = board.pieces(pt);
+        Bitboard pieces = board.pieces(Us, pt);
         while (pieces) {
-            Square s = pop_lsb(&pieces);
-            score += pst(board.color_on(s), pt, s, ph);
+            Square s = pop_lsb(pieces);
+            score += pst(Us, pt, s, ph);
             
             // Mobility calculation
             if (pt != QUEEN || ph == MG) { // Queen mobility only in MG
                 int mob = Mobility::count(board, s, pt);
                 score += weights.mobility[pt].value(ph) * mob;
-                info.mobility[board.color_on(s)][pt] += mob;
+                info.mobility[Us][pt] += mob;
             }
         }
     }
@@ -131,4 +136,10 @@ Score evaluate_pieces(const Board& board, EvalInfo& info, Phase ph) {
     return score;
 }
 
+} // namespace
+
+Score evaluate_pieces(const Board& board, EvalInfo& info, Phase ph) {
+    return evaluate_pieces<WHITE>(board, info, ph) + evaluate_pieces<BLACK>(board, info, ph);
+}
+
 } // namespace Eval
\ No newline at end of file
@@ -43,51 +43,32 @@ void init() {
     // ... other weights
 }
 
-Score evaluate(const Board& board, Color kingColor) {
-    const Square kingSquare = board.king_square(kingColor);
-    const Color enemy = ~kingColor;
-    
-    // 1. King shelter (pawn structure around king)
-    Score shelter = evaluate_shelter(board, kingColor);
-    
-    // 2. Pawn storms (enemy pawns attacking king zone)
-    Score storm = evaluate_storm(board, kingColor);
-    
-    // 3. Piece attacks
-    Score attacks = evaluate_attacks(board, kingColor);
-    
-    // 4. Weak squares around king
-    Score weak = evaluate_weak_squares(board, kingColor);
-    
-    // Combine scores with safety table lookup
-    Score safety = SafetyTable[0][kingSquare] + shelter + storm + attacks + weak;
-    
-    // Scale by game phase (less important in endgame)
-    int phase = board.game_phase();
-    return (safety * phase) / 24;
-}
-
-Score evaluate_shelter(const Board& board, Color kingColor) {
-    const Square kingSquare = board.king_square(kingColor);
+// Each term is instantiated per color: the king's side, the pawn attack
+// direction and the enemy are compile-time constants inside the template,
+// and the public entry points dispatch on the color once.
+template <Color Us>
+Score evaluate_shelter(const Board& board) {
+    const Square kingSquare = board.king_square(Us);
     Bitboard shelterZone = Attack::king_zone(kingSquare) & ~board.pieces(PAWN);
     
     int holes = popcount(shelterZone);
-    int pawnCover = popcount(Attack::pawn_attacks(kingColor, kingSquare) & 
-                            board.pieces(kingColor, PAWN));
+    int pawnCover = popcount(Attack::pawn_attacks(Us, kingSquare) & 
+                            board.pieces(Us, PAWN));
     
-    return -20 * holes + 15 * pawnCover;
+    return Score(-20 * holes + 15 * pawnCover);
 }
 
-Score evaluate_attacks(const Board& board, Color kingColor) {
-    const Square kingSquare = board.king_square(kingColor);
-    const Color enemy = ~kingColor;
+template <Color Us>
+Score evaluate_attacks(const Board& board) {
+    constexpr Color Them = ~Us;
+    const Square kingSquare = board.king_square(Us);
     
     int attackScore = 0;
-    Bitboard attackers = board.attackers_to(kingSquare, enemy);
+    Bitboard attackers = board.attacks_to<Them>(kingSquare);
     
     while (attackers) {
-        Square s = pop_lsb(&attackers);
-        PieceType pt = board.piece_on(s).type();
+        Square s = pop_lsb(attackers);
+        PieceType pt = type_of(board.piece_on(s));
         
         switch (pt) {
             case QUEEN:  attackScore += weights.queen; break;
@@ -108,7 +89,43 @@ Score evaluate_attacks(const Board& board, Color kingColor) {
         attackScore *= 2;
     }
     
-    return attackScore;
+    return Score(attackScore);
+}
+
+template <Color Us>
+Score evaluate(const Board& board) {
+    const Square kingSquare = board.king_square(Us);
+    
+    // 1. King shelter (pawn structure around king)
+    Score shelter = evaluate_shelter<Us>(board);
+    
+    // 2. Pawn storms (enemy pawns attacking king zone)
+    Score storm = evaluate_storm(board, Us);
+    
+    // 3. Piece attacks
+    Score attacks = evaluate_attacks<Us>(board);
+    
+    // 4. Weak squares around king
+    Score weak = evaluate_weak_squares(board, Us);
+    
+    // Combine scores with safety table lookup
+    Score safety = SafetyTable[0][kingSquare] + shelter + storm + attacks + weak;
+    
+    // Scale by game phase (less important in endgame)
+    int phase = board.game_phase();
+    return (safety * phase) / 24;
+}
+
+Score evaluate(const Board& board, Color kingColor) {
+    return kingColor == WHITE ? evaluate<WHITE>(board) : evaluate<BLACK>(board);
+}
+
+Score evaluate_shelter(const Board& board, Color kingColor) {
+    return kingColor == WHITE ? evaluate_shelter<WHITE>(board) : evaluate_shelter<BLACK>(board);
+}
+
+Score evaluate_attacks(const Board& board, Color kingColor) {
+    return kingColor == WHITE ? evaluate_attacks<WHITE>(board) : evaluate_attacks<BLACK>(board);
 }
 
 bool is_in_danger(Score safetyScore) {
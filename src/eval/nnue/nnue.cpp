@@ -45,7 +45,7 @@ void extract_features(const Board& b, std::vector<float>& input) {
     input.assign(g_net.inputSize, 0.0f);
 
     for (int sq = 0; sq < 64; ++sq) {
-        Piece p = b.piece_at(sq);
+        Piece p = b.piece_on(sq);
         if (p == NO_PIECE) continue;
 
         // Your board.h should provide helpers; adapt if names differ
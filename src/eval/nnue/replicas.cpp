@@ -0,0 +1,43 @@
+#include "replicas.h"
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace NNUE {
+
+NetworkReplicas::NetworkReplicas(const Network& source, const Numa::Topology& topo) {
+    replicas.assign(topo.nodes(), Replica{ &source, Memory::PageMode::NORMAL, false });
+    if (topo.nodes() == 1)
+        return;
+
+    // One builder per node. A node whose CPUs cannot be bound still gets
+    // its own copy; only placement is lost. If memory runs out the node
+    // shares the source instead.
+    std::vector<std::thread> builders;
+    for (size_t node = 0; node < topo.nodes(); ++node)
+        builders.emplace_back([&, node] {
+            topo.bind_current_thread(node);
+            Replica& r = replicas[node];
+            void* mem = Memory::alloc_large(sizeof(Network), false, r.mode);
+            if (!mem)
+                return;
+            std::memcpy(mem, &source, sizeof(Network));
+            r.net = static_cast<const Network*>(mem);
+            r.owned = true;
+        });
+    for (std::thread& t : builders)
+        t.join();
+
+    for (size_t node = 0; node < replicas.size(); ++node)
+        if (!replicas[node].owned)
+            std::cerr << "info string NNUE replica for node " << node
+                      << " failed, sharing the source" << std::endl;
+}
+
+NetworkReplicas::~NetworkReplicas() {
+    for (Replica& r : replicas)
+        if (r.owned)
+            Memory::free_large(const_cast<Network*>(r.net), sizeof(Network), r.mode);
+}
+
+} // namespace NNUE
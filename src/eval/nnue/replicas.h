@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "architecture.h"
+#include "util/memory.h"
+#include "util/numa.h"
+
+namespace NNUE {
+
+// Read-only copies of a Network, one per NUMA node, so that every search
+// thread reads feature_weights from its own node's memory. Each copy is
+// allocated and written by a thread bound to the node it serves, and first
+// touch places its pages there. With a single node nothing is copied and
+// the source itself is handed out, so it must outlive the replicas.
+class NetworkReplicas {
+public:
+    NetworkReplicas(const Network& source, const Numa::Topology& topo);
+    ~NetworkReplicas();
+    NetworkReplicas(const NetworkReplicas&) = delete;
+    NetworkReplicas& operator=(const NetworkReplicas&) = delete;
+
+    const Network& on_node(size_t node) const { return *replicas[node].net; }
+    size_t size() const { return replicas.size(); }
+
+private:
+    struct Replica {
+        const Network* net;
+        Memory::PageMode mode;
+        bool owned;              // Allocated here, rather than the source
+    };
+    std::vector<Replica> replicas;
+};
+
+} // namespace NNUE
@@ -28,7 +28,7 @@ static std::vector<float> board_to_input(const Board& board) {
     std::vector<float> input(INPUT_SIZE, 0.0f);
     // Example piece encoding: 0-5 white pieces, 6-11 black pieces
     for (int sq = 0; sq < 64; ++sq) {
-        Piece p = board.piece_at(sq);
+        Piece p = board.piece_on(sq);
         if (p != NO_PIECE) {
             int type_index = (is_white(p) ? 0 : 6) + piece_type(p);
             input[type_index * 64 + sq] = 1.0f;
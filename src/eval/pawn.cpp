@@ -1,6 +1,7 @@
 #include "pawn.h"
 #include "tuner.h"
-#include "magic.h"
+#include "attack.h"
+#include "util/prefetch.h"
 #include <array>
 
 namespace {
@@ -18,80 +19,11 @@ struct {
     Tuner::TuneParam backward = {"BackwardPawn", -15, -25, -5};
 } weights;
 
-// Initialize pawn-related bitboards
-void init_pawn_masks() {
-    // Initialization of attack tables etc.
-    // ... (typically handled by magic bitboards)
-}
-
-} // namespace
-
-namespace Pawn {
-
-void init() {
-    init_pawn_masks();
-    
-    // Register tunable parameters
-    Tuner::Tuner.add_parameter(weights.passed_pawn);
-    Tuner::Tuner.add_parameter(weights.candidate);
-    // ... other parameters
-}
-
-const PawnInfo& evaluate(const Board& board) {
-    // Probe pawn hash table
-    uint64_t key = board.pawn_key() % PAWN_HASH_SIZE;
-    PawnInfo& pi = pawnHashTable[key];
-    
-    // Reuse if already computed
-    if (pi.score != 0 || board.pawns() == 0)
-        return pi;
-    
-    // Reset info
-    pi = PawnInfo();
-    
-    // Evaluate for both colors
-    for (Color c : {WHITE, BLACK}) {
-        Bitboard pawns = board.pieces(c, PAWN);
-        
-        // Pawn attacks
-        pi.pawn_attacks[c] = pawn_attacks_bb(c, pawns);
-        
-        // Passed pawns
-        pi.passed_pawns[c] = 0;
-        while (pawns) {
-            Square s = pop_lsb(&pawns);
-            
-            // Passed pawn detection
-            if ((passed_pawn_mask(c, s) & board.pieces(~c, PAWN)) == 0) {
-                pi.passed_pawns[c] |= square_bb(s);
-                pi.score += (c == WHITE ? 1 : -1) * evaluate_passed_pawn(board, s);
-            }
-            
-            // Weak pawn detection
-            if (is_isolated(board, c, s) || is_backward(board, c, s)) {
-                pi.weak_pawns[c] |= square_bb(s);
-                pi.score += (c == WHITE ? 1 : -1) * weights.isolated.value();
-            }
-            
-            // Doubled pawns
-            if (is_doubled(board, c, s)) {
-                pi.score += (c == WHITE ? 1 : -1) * weights.doubled.value();
-            }
-        }
-        
-        // King safety
-        pi.king_safety[c] = evaluate_king_shield(board, c);
-        
-        // Candidate pawns
-        pi.candidate_pawns[c] = find_candidate_pawns(board, c);
-    }
-    
-    return pi;
-}
+using Pawn::Score;
 
+template <Color Us>
 Score evaluate_passed_pawn(const Board& board, Square pawn_sq) {
-    Color c = color_of(board.piece_on(pawn_sq));
-    int rank = relative_rank(c, pawn_sq);
+    int rank = relative_rank(Us, pawn_sq);
     
     // Bonus increases with advancement
     static constexpr int PassedRankBonus[8] = {
@@ -101,48 +33,136 @@ Score evaluate_passed_pawn(const Board& board, Square pawn_sq) {
     Score bonus = weights.passed_pawn.value() + PassedRankBonus[rank];
     
     // Add bonus if supported by own pawns
-    if (board.pieces(c, PAWN) & adjacent_files_bb(file_of(pawn_sq)))
+    if (board.pieces(Us, PAWN) & Attack::adjacent_files(file_of(pawn_sq)))
         bonus += bonus / 2;
     
     return bonus;
 }
 
-Score evaluate_king_shield(const Board& board, Color c) {
-    Square king_sq = board.king_square(c);
+template <Color Us>
+Score evaluate_king_shield(const Board& board) {
+    Square king_sq = board.king_square(Us);
     Score shield = 0;
     
     // Only evaluate in middlegame
     if (board.non_pawn_material() < 6000) {
-        Bitboard shield_bb = pawn_attacks_bb(c, board.pieces(c, PAWN)) & 
-                           king_zone_bb(king_sq);
+        Bitboard shield_bb = Attack::pawn_attacks<Us>(board.pieces(Us, PAWN)) & 
+                           Attack::king_zone(king_sq);
         shield = popcount(shield_bb) * weights.shield;
     }
     
     return shield;
 }
 
-Bitboard find_candidate_pawns(const Board& board, Color c) {
+template <Color Us>
+bool is_candidate_pawn(const Board& board, Square s) {
+    // A pawn is candidate if:
+    // 1. Not blocked by enemy pawns
+    // 2. Has potential to become passed
+    // 3. Supported by friendly pawns
+    
+    Bitboard forward = Attack::forward_file(Us, s);
+    return !(forward & board.pieces(~Us, PAWN)) &&
+           (Attack::adjacent_files(file_of(s)) & board.pieces(Us, PAWN));
+}
+
+template <Color Us>
+Bitboard find_candidate_pawns(const Board& board) {
     Bitboard candidates = 0;
-    Bitboard pawns = board.pieces(c, PAWN);
+    Bitboard pawns = board.pieces(Us, PAWN);
     
     while (pawns) {
-        Square s = pop_lsb(&pawns);
-        if (is_candidate_pawn(board, c, s))
+        Square s = pop_lsb(pawns);
+        if (is_candidate_pawn<Us>(board, s))
             candidates |= square_bb(s);
     }
     
     return candidates;
 }
 
-bool is_candidate_pawn(const Board& board, Color c, Square s) {
-    // A pawn is candidate if:
-    // 1. Not blocked by enemy pawns
-    // 2. Has potential to become passed
-    // 3. Supported by friendly pawns
+// One side's pawn structure. Us is a template parameter so the sign, the
+// pawn shifts and the rank masks are all compile-time constants.
+template <Color Us>
+void evaluate_side(const Board& board, Pawn::PawnInfo& pi) {
+    using namespace Pawn;
+    constexpr Color Them = ~Us;
+    constexpr int   Sign = Us == WHITE ? 1 : -1;
+
+    Bitboard pawns = board.pieces(Us, PAWN);
+    const Bitboard theirPawns = board.pieces(Them, PAWN);
+
+    // Pawn attacks
+    pi.pawn_attacks[Us] = Attack::pawn_attacks<Us>(pawns);
+
+    // Passed pawns
+    pi.passed_pawns[Us] = 0;
+    while (pawns) {
+        Square s = pop_lsb(pawns);
+
+        // Passed pawn detection
+        if ((Attack::passed_pawn_mask(Us, s) & theirPawns) == 0) {
+            pi.passed_pawns[Us] |= square_bb(s);
+            pi.score += Sign * evaluate_passed_pawn<Us>(board, s);
+        }
+
+        // Weak pawn detection
+        if (is_isolated(board, Us, s) || is_backward(board, Us, s)) {
+            pi.weak_pawns[Us] |= square_bb(s);
+            pi.score += Sign * weights.isolated.value();
+        }
+
+        // Doubled pawns
+        if (is_doubled(board, Us, s)) {
+            pi.score += Sign * weights.doubled.value();
+        }
+    }
+
+    // King safety
+    pi.king_safety[Us] = evaluate_king_shield<Us>(board);
+
+    // Candidate pawns
+    pi.candidate_pawns[Us] = find_candidate_pawns<Us>(board);
+}
+
+} // namespace
+
+namespace Pawn {
+
+void init() {
+    // Pawn masks are constexpr tables in attack.h, nothing to build here
+
+    // Register tunable parameters
+    Tuner::Tuner.add_parameter(weights.passed_pawn);
+    Tuner::Tuner.add_parameter(weights.candidate);
+    // ... other parameters
+}
+
+const PawnInfo& evaluate(const Board& board) {
+    // Probe pawn hash table
+    uint64_t key = board.pawn_key() % PAWN_HASH_SIZE;
+    PawnInfo& pi = pawnHashTable[key];
+    
+    // Reuse if already computed
+    if (pi.score != 0 || board.pawns() == 0)
+        return pi;
+    
+    // Reset info
+    pi = PawnInfo();
+    
+    // Evaluate for both colors, White adding and Black subtracting
+    evaluate_side<WHITE>(board, pi);
+    evaluate_side<BLACK>(board, pi);
     
-    Bitboard forward = forward_bb(c, s);
-    return !(forward & board.pieces(~c, PAWN)) &&
-           (adjacent_files_bb(s) & board.pieces(c, PAWN));
+    return pi;
+}
+
+void prefetch(Key pawnKey) {
+    ChessEngine::prefetch<ChessEngine::PrefetchType::PAWN_READ>(&pawnHashTable[pawnKey % PAWN_HASH_SIZE]);
+}
+
+Score evaluate_king_shield(const Board& board, Color c) {
+    return c == WHITE ? evaluate_king_shield<WHITE>(board)
+                      : evaluate_king_shield<BLACK>(board);
 }
 
 } // namespace Pawn
\ No newline at end of file
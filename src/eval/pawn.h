@@ -35,6 +35,9 @@ void init();
 // Evaluate pawn structure (cached)
 const PawnInfo& evaluate(const Board& board);
 
+// Start loading the hash slot of a pawn key, e.g. Board::pawn_key_after
+void prefetch(Key pawnKey);
+
 // Detailed evaluation components
 Score evaluate_passed_pawns(const Board& board, Color color);
 Score evaluate_king_shield(const Board& board, Color color);
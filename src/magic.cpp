@@ -0,0 +1,170 @@
+#include "magic.h"
+#include "attack.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+namespace Magic {
+
+namespace {
+
+// Sum over squares of 2^popcount(mask)
+constexpr int ROOK_TABLE_SIZE   = 0x19000;
+constexpr int BISHOP_TABLE_SIZE = 0x1480;
+
+Bitboard RookFancyTable[ROOK_TABLE_SIZE];
+Bitboard BishopFancyTable[BISHOP_TABLE_SIZE];
+#ifdef HAS_PEXT
+Bitboard RookPextTable[ROOK_TABLE_SIZE];
+Bitboard BishopPextTable[BISHOP_TABLE_SIZE];
+#else
+constexpr Bitboard* RookPextTable   = nullptr;
+constexpr Bitboard* BishopPextTable = nullptr;
+#endif
+
+// Found offline with a seeded sparse-random search over the masks below.
+// Any change to the mask definition needs a new set.
+constexpr Bitboard RookMagics[SQUARE_NB] = {
+    0x0a80004000801220ULL, 0x8040004010002008ULL, 0x2080200010008008ULL, 0x1100100008210004ULL,
+    0xc200209084020008ULL, 0x2100010004000208ULL, 0x0400081000822421ULL, 0x0200010422048844ULL,
+    0x0800800080400024ULL, 0x0001402000401000ULL, 0x3000801000802001ULL, 0x4400800800100083ULL,
+    0x0904802402480080ULL, 0x4040800400020080ULL, 0x0018808042000100ULL, 0x4040800080004100ULL,
+    0x0040048001458024ULL, 0x00a0004000205000ULL, 0x3100808010002000ULL, 0x4825010010000820ULL,
+    0x5004808008000401ULL, 0x2024818004000a00ULL, 0x0005808002000100ULL, 0x2100060004806104ULL,
+    0x0080400880008421ULL, 0x4062220600410280ULL, 0x010a004a00108022ULL, 0x0000100080080080ULL,
+    0x0021000500080010ULL, 0x0044000202001008ULL, 0x0000100400080102ULL, 0xc020128200040545ULL,
+    0x0080002000400040ULL, 0x0000804000802004ULL, 0x0000120022004080ULL, 0x010a386103001001ULL,
+    0x9010080080800400ULL, 0x8440020080800400ULL, 0x0004228824001001ULL, 0x000000490a000084ULL,
+    0x0080002000504000ULL, 0x200020005000c000ULL, 0x0012088020420010ULL, 0x0010010080080800ULL,
+    0x0085001008010004ULL, 0x0002000204008080ULL, 0x0040413002040008ULL, 0x0000304081020004ULL,
+    0x0080204000800080ULL, 0x3008804000290100ULL, 0x1010100080200080ULL, 0x2008100208028080ULL,
+    0x5000850800910100ULL, 0x8402019004680200ULL, 0x0120911028020400ULL, 0x0000008044010200ULL,
+    0x0020850200244012ULL, 0x0020850200244012ULL, 0x0000102001040841ULL, 0x140900040a100021ULL,
+    0x000200282410a102ULL, 0x000200282410a102ULL, 0x000200282410a102ULL, 0x4048240043802106ULL
+};
+
+constexpr Bitboard BishopMagics[SQUARE_NB] = {
+    0x40106000a1160020ULL, 0x0020010250810120ULL, 0x2010010220280081ULL, 0x002806004050c040ULL,
+    0x0002021018000000ULL, 0x2001112010000400ULL, 0x0881010120218080ULL, 0x1030820110010500ULL,
+    0x0000120222042400ULL, 0x2000020404040044ULL, 0x8000480094208000ULL, 0x0003422a02000001ULL,
+    0x000a220210100040ULL, 0x8004820202226000ULL, 0x0018234854100800ULL, 0x0100004042101040ULL,
+    0x0004001004082820ULL, 0x0010000810010048ULL, 0x1014004208081300ULL, 0x2080818802044202ULL,
+    0x0040880c00a00100ULL, 0x0080400200522010ULL, 0x0001000188180b04ULL, 0x0080249202020204ULL,
+    0x1004400004100410ULL, 0x00013100a0022206ULL, 0x2148500001040080ULL, 0x4241080011004300ULL,
+    0x4020848004002000ULL, 0x10101380d1004100ULL, 0x0008004422020284ULL, 0x01010a1041008080ULL,
+    0x0808080400082121ULL, 0x0808080400082121ULL, 0x0091128200100c00ULL, 0x0202200802010104ULL,
+    0x8c0a020200440085ULL, 0x01a0008080b10040ULL, 0x0889520080122800ULL, 0x100902022202010aULL,
+    0x04081a0816002000ULL, 0x0000681208005000ULL, 0x8170840041008802ULL, 0x0a00004200810805ULL,
+    0x0830404408210100ULL, 0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+    0x0602010120110040ULL, 0x0941010801043000ULL, 0x000040440a210428ULL, 0x0008240020880021ULL,
+    0x0400002012048200ULL, 0x00ac102001210220ULL, 0x0220021002009900ULL, 0x84440c080a013080ULL,
+    0x0001008044200440ULL, 0x0004c04410841000ULL, 0x2000500104011130ULL, 0x1a0c010011c20229ULL,
+    0x0044800112202200ULL, 0x0434804908100424ULL, 0x0300404822c08200ULL, 0x48081010008a2a80ULL
+};
+
+constexpr Bitboard relevant_mask(PieceType pt, Square s) {
+    const Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~rank_bb(s))
+                         | ((FILE_A_BB | FILE_H_BB) & ~file_bb(s));
+    return Attack::sliding_attacks(pt, s, 0) & ~edges;
+}
+
+constexpr int bit_count(Bitboard b) {
+    int n = 0;
+    for (; b; b &= b - 1)
+        ++n;
+    return n;
+}
+
+// Per-square entries; each square's slice starts where the previous one ends
+constexpr std::array<Entry, SQUARE_NB> make_entries(PieceType pt, Bitboard* table,
+                                                     const Bitboard (&magics)[SQUARE_NB]) {
+    std::array<Entry, SQUARE_NB> entries{};
+    unsigned offset = 0;
+    for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+        const Bitboard mask = relevant_mask(pt, s);
+        entries[s] = { mask, magics[s], table ? table + offset : nullptr, unsigned(64 - bit_count(mask)) };
+        offset += 1u << bit_count(mask);
+    }
+    return entries;
+}
+
+// Walk every occupancy subset of each mask and store its attacks in both layouts.
+// Carry-Rippler visits subsets in PEXT index order, so the i-th subset is slot i.
+void fill(PieceType pt, const std::array<Entry, SQUARE_NB>& fancy,
+          const std::array<Entry, SQUARE_NB>& pext) {
+    for (Square s = SQ_A1; s <= SQ_H8; ++s) {
+        const Entry& e = fancy[s];
+        unsigned i = 0;
+        Bitboard b = 0;
+        do {
+            const Bitboard attacks = Attack::sliding_attacks(pt, s, b);
+            e.attacks[e.fancy_index(b)] = attacks;
+            if (pext[s].attacks)
+                pext[s].attacks[i] = attacks;
+            ++i;
+            b = (b - e.mask) & e.mask;
+        } while (b);
+    }
+}
+
+} // namespace
+
+constexpr std::array<Entry, SQUARE_NB> RookFancy   = make_entries(ROOK,   RookFancyTable,   RookMagics);
+constexpr std::array<Entry, SQUARE_NB> BishopFancy = make_entries(BISHOP, BishopFancyTable, BishopMagics);
+constexpr std::array<Entry, SQUARE_NB> RookPext    = make_entries(ROOK,   RookPextTable,    RookMagics);
+constexpr std::array<Entry, SQUARE_NB> BishopPext  = make_entries(BISHOP, BishopPextTable,  BishopMagics);
+bool UsePext = false;
+
+void init() {
+    fill(ROOK,   RookFancy,   RookPext);
+    fill(BISHOP, BishopFancy, BishopPext);
+    set_backend(cpu_has_fast_pext() ? Backend::PEXT : Backend::FANCY);
+}
+
+bool cpu_has_fast_pext() {
+#if defined(HAS_PEXT) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & (1u << 8)))
+        return false;  // No BMI2
+
+    // Vendor string is EBX:EDX:ECX of leaf 0
+    char vendor[13] = {};
+    __get_cpuid(0, &eax, &ebx, &ecx, &edx);
+    std::memcpy(vendor + 0, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    if (std::strcmp(vendor, "AuthenticAMD") != 0)
+        return true;
+
+    // Zen 1/2 (family 0x17) and older microcode PEXT; Zen 3 (0x19) is fast
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    unsigned family = (eax >> 8) & 0xF;
+    if (family == 0xF)
+        family += (eax >> 20) & 0xFF;
+    return family >= 0x19;
+#else
+    return false;
+#endif
+}
+
+Backend backend() {
+    return UsePext ? Backend::PEXT : Backend::FANCY;
+}
+
+bool set_backend(Backend b) {
+#ifdef HAS_PEXT
+    UsePext = b == Backend::PEXT;
+    return true;
+#else
+    UsePext = false;
+    return b == Backend::FANCY;
+#endif
+}
+
+const char* backend_name(Backend b) {
+    return b == Backend::PEXT ? "pext" : "fancy";
+}
+
+} // namespace Magic
@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include "bitboard.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#define HAS_PEXT 1
+#endif
+
+// Slider attack lookups. Two table layouts share the same per-square sizes:
+//  - FANCY: classic fancy magics, index = ((occ & mask) * magic) >> shift
+//  - PEXT:  index = pext(occ, mask), only compiled in when BMI2 is available
+// The backend is picked once at startup; PEXT is skipped on CPUs where it is
+// microcoded (AMD Zen 1/2) because it is slower than a multiply there.
+//
+// Masks, magics and table offsets are constexpr. Only the attack sets are
+// filled at startup: building them at compile time costs more than GCC's
+// default constexpr operation budget.
+namespace Magic {
+
+enum class Backend : uint8_t { FANCY, PEXT };
+
+struct Entry {
+    Bitboard  mask;     // Relevant occupancy (board edges excluded)
+    Bitboard  magic;    // Multiplier, unused by the PEXT layout
+    Bitboard* attacks;  // This square's slice of the shared attack table
+    unsigned  shift;    // 64 - popcount(mask)
+
+    unsigned fancy_index(Bitboard occ) const {
+        return unsigned(((occ & mask) * magic) >> shift);
+    }
+#ifdef HAS_PEXT
+    unsigned pext_index(Bitboard occ) const {
+        return unsigned(_pext_u64(occ, mask));
+    }
+#endif
+};
+
+extern const std::array<Entry, SQUARE_NB> RookFancy;
+extern const std::array<Entry, SQUARE_NB> BishopFancy;
+extern const std::array<Entry, SQUARE_NB> RookPext;
+extern const std::array<Entry, SQUARE_NB> BishopPext;
+extern bool UsePext;
+
+// Fill the attack tables and pick the backend for this CPU (call once at startup)
+void init();
+
+// True if BMI2 is present and PEXT runs in hardware
+bool cpu_has_fast_pext();
+
+Backend backend();
+bool set_backend(Backend b);  // False if the backend was not compiled in
+const char* backend_name(Backend b);
+
+// Lookup through a fixed backend, no dispatch (used by benchmarks)
+template <Backend B, PieceType Pt>
+inline Bitboard lookup(Square s, Bitboard occ) {
+    static_assert(Pt == BISHOP || Pt == ROOK, "Slider lookups only");
+#ifdef HAS_PEXT
+    if constexpr (B == Backend::PEXT) {
+        const Entry& e = Pt == ROOK ? RookPext[s] : BishopPext[s];
+        return e.attacks[e.pext_index(occ)];
+    }
+#endif
+    const Entry& e = Pt == ROOK ? RookFancy[s] : BishopFancy[s];
+    return e.attacks[e.fancy_index(occ)];
+}
+
+// Lookup through the backend selected at startup
+template <PieceType Pt>
+inline Bitboard attacks(Square s, Bitboard occ) {
+#ifdef HAS_PEXT
+    if (UsePext)
+        return lookup<Backend::PEXT, Pt>(s, occ);
+#endif
+    return lookup<Backend::FANCY, Pt>(s, occ);
+}
+
+} // namespace Magic
+
+inline Bitboard get_bishop_attacks(int sq, Bitboard occ) {
+    return Magic::attacks<BISHOP>(Square(sq), occ);
+}
+
+inline Bitboard get_rook_attacks(int sq, Bitboard occ) {
+    return Magic::attacks<ROOK>(Square(sq), occ);
+}
+
+inline Bitboard get_queen_attacks(int sq, Bitboard occ) {
+    return get_bishop_attacks(sq, occ) | get_rook_attacks(sq, occ);
+}
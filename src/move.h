@@ -1,101 +1,67 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
 #include <string>
 #include <cassert>
+#include "types.h"
 
-enum PieceType : uint8_t { NONE, PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
-enum Color : uint8_t { WHITE, BLACK, COLOR_NONE };
-
-// Optimized Move representation (32 bits total)
+// Compact Move representation (16 bits total), the one encoding used by move
+// lists, killers, countermoves, history and the transposition table.
 // Bit layout:
 // 0-5:   from square (0-63)
-// 6-11:  to square (0-63)
-// 12-14: promotion piece (NONE, KNIGHT, BISHOP, ROOK, QUEEN)
-// 15-17: move flags (normal, promotion, en passant, castling)
-// 18-31: unused (future expansion)
+// 6-11:  to square (0-63); the king's destination for castling
+// 12-13: promotion piece - KNIGHT (only meaningful for PROMOTION)
+// 14-15: special move type (normal, promotion, en passant, castling)
+// Moving and captured pieces are read from the board, not stored here.
 class Move {
 public:
-    // Move flags (bit 15-17)
-    enum Flag : uint8_t {
-        NORMAL      = 0,
-        PROMOTION   = 1 << 0,
-        EN_PASSANT  = 1 << 1,
-        CASTLING    = 1 << 2,
-        DOUBLE_PUSH = 1 << 3  // For pawn history
+    // Move types (bits 14-15)
+    enum Type : uint16_t {
+        NORMAL     = 0,
+        PROMOTION  = 1 << 14,
+        EN_PASSANT = 2 << 14,
+        CASTLING   = 3 << 14
     };
 
-    Move() : move_(0) {}
-    
+    constexpr Move() : move_(0) {}
+    constexpr explicit Move(uint16_t raw) : move_(raw) {}
+
     // Main constructor
-    Move(int from, int to, PieceType promo = NONE, uint8_t flags = NORMAL) {
+    constexpr Move(int from, int to, PieceType promo = NONE, Type type = NORMAL)
+        : move_(static_cast<uint16_t>(from | (to << 6) | type
+                | (promo != NONE ? (promo - KNIGHT) << 12 : 0))) {
         assert(from >= 0 && from < 64);
         assert(to >= 0 && to < 64);
-        assert(promo <= QUEEN);  // Only allow promotions to Q, R, B, N
-        
-        move_ = (static_cast<uint32_t>(from) |
-               (static_cast<uint32_t>(to) << 6) |
-               (static_cast<uint32_t>(promo) << 12) |
-               (static_cast<uint32_t>(flags) << 15));
+        assert(promo == NONE || (promo >= KNIGHT && promo <= QUEEN));
     }
 
     // Accessors
-    int from() const { return move_ & 0x3F; }
-    int to() const { return (move_ >> 6) & 0x3F; }
-    PieceType promotion_piece() const { return static_cast<PieceType>((move_ >> 12) & 0x7); }
-    uint8_t flags() const { return (move_ >> 15) & 0xF; }
+    constexpr int from() const { return move_ & 0x3F; }
+    constexpr int to() const { return (move_ >> 6) & 0x3F; }
+    constexpr Type type() const { return static_cast<Type>(move_ & (3 << 14)); }
+    constexpr PieceType promotion_piece() const {
+        return is_promotion() ? static_cast<PieceType>(KNIGHT + ((move_ >> 12) & 3)) : NONE;
+    }
+    constexpr uint16_t raw() const { return move_; }
 
     // Predicates
-    bool is_promotion() const { return flags() & PROMOTION; }
-    bool is_castle() const { return flags() & CASTLING; }
-    bool is_enpassant() const { return flags() & EN_PASSANT; }
-    bool is_double_push() const { return flags() & DOUBLE_PUSH; }
-    bool is_valid() const { return move_ != 0; }
+    constexpr bool is_promotion() const { return type() == PROMOTION; }
+    constexpr bool is_castle() const { return type() == CASTLING; }
+    constexpr bool is_enpassant() const { return type() == EN_PASSANT; }
+    constexpr bool is_valid() const { return from() != to(); }  // Rejects none()
 
     // Comparison
-    bool operator==(const Move& other) const { return move_ == other.move_; }
-    bool operator!=(const Move& other) const { return !(*this == other); }
+    constexpr bool operator==(const Move& other) const { return move_ == other.move_; }
+    constexpr bool operator!=(const Move& other) const { return !(*this == other); }
 
     // String conversion (UCI format)
-    std::string to_uci() const {
-        if (!is_valid()) return "0000";
-        
-        std::string result;
-        result += static_cast<char>('a' + (from() % 8));
-        result += static_cast<char>('1' + (from() / 8));
-        result += static_cast<char>('a' + (to() % 8));
-        result += static_cast<char>('1' + (to() / 8));
-        
-        if (is_promotion()) {
-            const char promos[] = {'n', 'b', 'r', 'q'};
-            result += promos[promotion_piece() - KNIGHT];
-        }
-        
-        return result;
-    }
+    std::string to_uci() const;
 
-    // Static constructors
-    static Move from_uci(const std::string& uci) {
-        if (uci == "0000") return none();
-        
-        int from = (uci[0] - 'a') + 8 * (uci[1] - '1');
-        int to = (uci[2] - 'a') + 8 * (uci[3] - '1');
-        PieceType promo = NONE;
-        uint8_t flags = NORMAL;
-        
-        if (uci.length() > 4) {
-            flags |= PROMOTION;
-            switch (uci[4]) {
-                case 'n': promo = KNIGHT; break;
-                case 'b': promo = BISHOP; break;
-                case 'r': promo = ROOK; break;
-                case 'q': promo = QUEEN; break;
-            }
-        }
-        
-        return Move(from, to, promo, flags);
-    }
+    // Parses squares and promotion only. En passant and castling need the
+    // board to be recognised; use parse_move() from movegen.h for input.
+    static Move from_uci(const std::string& uci);
 
-    static Move none() { return Move(); }
+    static constexpr Move none() { return Move(); }
 
     // For std::unordered_map support
     struct Hash {
@@ -105,5 +71,9 @@ public:
     };
 
 private:
-    uint32_t move_;  // Compact 32-bit representation
-};
\ No newline at end of file
+    uint16_t move_;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay 16 bits");
+
+inline constexpr Move MOVE_NONE = Move::none();
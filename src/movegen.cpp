@@ -0,0 +1,289 @@
+#include "movegen.h"
+#include "attack.h"
+#include "magic.h"
+#include "serialize.h"
+#include <cassert>
+
+namespace {
+
+// Legality information shared by all piece generators of one call
+struct LegalMasks {
+    Square   ksq;
+    Bitboard checkers;
+    Bitboard checkMask;  // Non-king moves must land here (all squares when not in check)
+    Bitboard pinHV;      // Rank/file pin rays, king side exclusive, pinner inclusive
+    Bitboard pinD;       // Diagonal pin rays
+};
+
+template <Color Us>
+LegalMasks legal_masks(const Board& pos) {
+    constexpr Color Them = ~Us;
+    LegalMasks m;
+    m.ksq = lsb(pos.pieces(Us, KING));
+    m.checkers = pos.attacks_to<Them>(m.ksq);
+    m.pinHV = m.pinD = 0;
+
+    const Bitboard occ = pos.pieces();
+    const Bitboard rq = pos.pieces(Them, ROOK) | pos.pieces(Them, QUEEN);
+    const Bitboard bq = pos.pieces(Them, BISHOP) | pos.pieces(Them, QUEEN);
+
+    // Sliders seen from the king through our own pieces only
+    Bitboard snipers = get_rook_attacks(m.ksq, pos.pieces(Them)) & rq;
+    while (snipers) {
+        const Square s = pop_lsb(snipers);
+        const Bitboard ray = Attack::between(m.ksq, s);
+        const Bitboard blockers = ray & occ;
+        if (blockers && !more_than_one(blockers) && (blockers & pos.pieces(Us)))
+            m.pinHV |= ray | square_bb(s);
+    }
+    snipers = get_bishop_attacks(m.ksq, pos.pieces(Them)) & bq;
+    while (snipers) {
+        const Square s = pop_lsb(snipers);
+        const Bitboard ray = Attack::between(m.ksq, s);
+        const Bitboard blockers = ray & occ;
+        if (blockers && !more_than_one(blockers) && (blockers & pos.pieces(Us)))
+            m.pinD |= ray | square_bb(s);
+    }
+
+    if (!m.checkers)
+        m.checkMask = ~0ULL;
+    else if (!more_than_one(m.checkers))
+        m.checkMask = Attack::between(m.ksq, lsb(m.checkers)) | m.checkers;
+    else
+        m.checkMask = 0;  // Double check: king moves only
+
+    return m;
+}
+
+template <GenType Type, Direction D>
+Move* make_promotions(Move* list, Square to) {
+    constexpr bool all = Type == EVASIONS || Type == LEGAL;
+    const Square from = to - D;
+    if (Type == CAPTURES || all)
+        *list++ = Move(from, to, QUEEN, Move::PROMOTION);
+    if (Type == QUIETS || all) {
+        *list++ = Move(from, to, ROOK, Move::PROMOTION);
+        *list++ = Move(from, to, BISHOP, Move::PROMOTION);
+        *list++ = Move(from, to, KNIGHT, Move::PROMOTION);
+    }
+    return list;
+}
+
+// Capture-promotions are captures, so CAPTURES takes all four pieces
+template <GenType Type, Direction D>
+Move* make_capture_promotions(Move* list, Square to) {
+    constexpr bool all = Type == EVASIONS || Type == LEGAL;
+    if (Type == CAPTURES || all) {
+        const Square from = to - D;
+        for (PieceType pt : { QUEEN, ROOK, BISHOP, KNIGHT })
+            *list++ = Move(from, to, pt, Move::PROMOTION);
+    }
+    return list;
+}
+
+template <Color Us, GenType Type>
+Move* generate_pawn_moves(const Board& pos, Move* list, const LegalMasks& m, const CheckInfo* ci) {
+    constexpr Color     Them     = ~Us;
+    constexpr Direction Up       = pawn_push(Us);
+    constexpr Direction UpRight  = Us == WHITE ? NORTH_EAST : SOUTH_WEST;
+    constexpr Direction UpLeft   = Us == WHITE ? NORTH_WEST : SOUTH_EAST;
+    constexpr Bitboard  Rank3BB  = Us == WHITE ? RANK_3_BB : RANK_6_BB;
+    constexpr Bitboard  Rank8BB  = Us == WHITE ? RANK_8_BB : RANK_1_BB;
+
+    const Bitboard empty   = ~pos.pieces();
+    const Bitboard enemies = pos.pieces(Them);
+    const Bitboard pawns   = pos.pieces(Us, PAWN);
+
+    // A pawn pinned on a rank/file may only push along a file pin; a pawn
+    // pinned on a diagonal may only capture along that diagonal.
+    const Bitboard free = pawns & ~(m.pinHV | m.pinD);
+    const Bitboard single = (shift<Up>(free) | (shift<Up>(pawns & m.pinHV) & m.pinHV)) & empty;
+    const Bitboard dbl    = shift<Up>(single & Rank3BB) & empty;
+
+    // Pushes
+    if (Type != CAPTURES) {
+        Bitboard b1 = single & ~Rank8BB & m.checkMask;
+        Bitboard b2 = dbl & m.checkMask;
+
+        if (Type == QUIET_CHECKS) {
+            // Direct checks, plus pushes of discovered-check pawns off the king's file
+            const Bitboard dcPawns = pawns & ci->dcCandidates & ~file_bb(ci->ksq);
+            b1 &= ci->checkSquares[PAWN] | shift<Up>(dcPawns);
+            b2 &= ci->checkSquares[PAWN] | shift<Up>(shift<Up>(dcPawns));
+        }
+
+        list = Serialize::pawn_moves<Up>(list, b1);
+        list = Serialize::pawn_moves<Direction(Up + Up)>(list, b2);
+    }
+
+    if (Type == QUIET_CHECKS)
+        return list;
+
+    // Push promotions (queen is a CAPTURES move, underpromotions are QUIETS)
+    Bitboard promo = single & Rank8BB & m.checkMask;
+    while (promo)
+        list = make_promotions<Type, Up>(list, pop_lsb(promo));
+
+    // Captures, with the diagonal pin applied after the shift
+    if (Type != QUIETS) {
+        const Bitboard pinnedD = pawns & m.pinD;
+        const Bitboard capRight = (shift<UpRight>(free) | (shift<UpRight>(pinnedD) & m.pinD)) & enemies & m.checkMask;
+        const Bitboard capLeft  = (shift<UpLeft>(free)  | (shift<UpLeft>(pinnedD)  & m.pinD)) & enemies & m.checkMask;
+
+        list = Serialize::pawn_moves<UpRight>(list, capRight & ~Rank8BB);
+        list = Serialize::pawn_moves<UpLeft>(list, capLeft & ~Rank8BB);
+
+        Bitboard b = capRight & Rank8BB;
+        while (b)
+            list = make_capture_promotions<Type, UpRight>(list, pop_lsb(b));
+        b = capLeft & Rank8BB;
+        while (b)
+            list = make_capture_promotions<Type, UpLeft>(list, pop_lsb(b));
+
+        // En passant: both pawns leave the capture rank, so test the king directly
+        if (pos.ep_square() != SQ_NONE) {
+            const Square to = pos.ep_square();
+            const Square capsq = to - Up;
+            Bitboard candidates = pawns & Attack::pawn_attacks(Them, to);
+            while (candidates) {
+                const Square from = pop_lsb(candidates);
+                const Bitboard occ = (pos.pieces() ^ square_bb(from) ^ square_bb(capsq)) | square_bb(to);
+                if (!(pos.attackers_to(m.ksq, occ) & enemies & ~square_bb(capsq)))
+                    *list++ = Move(from, to, NONE, Move::EN_PASSANT);
+            }
+        }
+    }
+
+    return list;
+}
+
+template <Color Us, PieceType Pt, GenType Type>
+Move* generate_piece_moves(const Board& pos, Move* list, const LegalMasks& m,
+                           const CheckInfo* ci, Bitboard target) {
+    const Bitboard occ = pos.pieces();
+    Bitboard pieces = pos.pieces(Us, Pt);
+
+    // Pinned knights never move; sliders pinned across their move type never move
+    if (Pt == KNIGHT) pieces &= ~(m.pinHV | m.pinD);
+    if (Pt == BISHOP) pieces &= ~m.pinHV;
+    if (Pt == ROOK)   pieces &= ~m.pinD;
+
+    while (pieces) {
+        const Square from = pop_lsb(pieces);
+        Bitboard b = Pt == KNIGHT ? Attack::knight(from)
+                   : Pt == BISHOP ? get_bishop_attacks(from, occ)
+                   : Pt == ROOK   ? get_rook_attacks(from, occ)
+                   :                get_queen_attacks(from, occ);
+        b &= target;
+
+        // The union of all pin rays is not enough for a queen, which could
+        // step from its own ray onto another one; keep it on the king line.
+        if (square_bb(from) & (m.pinHV | m.pinD))
+            b &= Attack::line(m.ksq, from);
+
+        if (Type == QUIET_CHECKS)
+            b &= (square_bb(from) & ci->dcCandidates)
+                 ? ci->checkSquares[Pt] | ~Attack::line(from, ci->ksq)
+                 : ci->checkSquares[Pt];
+
+        list = Serialize::piece_moves(list, from, b);
+    }
+    return list;
+}
+
+template <Color Us, GenType Type>
+Move* generate_king_moves(const Board& pos, Move* list, const LegalMasks& m,
+                          const CheckInfo* ci, Bitboard target) {
+    constexpr Color Them = ~Us;
+    const Bitboard occ = pos.pieces() ^ square_bb(m.ksq);  // King does not block its own x-ray
+
+    Bitboard b = Attack::king(m.ksq) & target;
+    if (Type == QUIET_CHECKS)
+        b = (square_bb(m.ksq) & ci->dcCandidates) ? b & ~Attack::line(m.ksq, ci->ksq) : 0;
+
+    while (b) {
+        const Square to = pop_lsb(b);
+        if (!(pos.attackers_to(to, occ) & pos.pieces(Them)))
+            *list++ = Move(m.ksq, to);
+    }
+
+    // Castling: the king may not start in, pass through or land on an attacked square
+    if ((Type == QUIETS || Type == LEGAL) && !m.checkers) {
+        constexpr uint8_t KingSide  = Us == WHITE ? 1 : 4;
+        constexpr uint8_t QueenSide = Us == WHITE ? 2 : 8;
+        constexpr Square  KingFrom  = relative_square(Us, SQ_E1);
+
+        auto safe = [&](Square s) { return !pos.attacks_to<Them>(s); };
+
+        if (m.ksq == KingFrom && (pos.castling_rights() & KingSide)
+            && (pos.pieces(Us, ROOK) & square_bb(relative_square(Us, SQ_H1)))
+            && !(pos.pieces() & (square_bb(relative_square(Us, SQ_F1)) | square_bb(relative_square(Us, SQ_G1))))
+            && safe(relative_square(Us, SQ_F1)) && safe(relative_square(Us, SQ_G1)))
+            *list++ = Move(KingFrom, relative_square(Us, SQ_G1), NONE, Move::CASTLING);
+
+        if (m.ksq == KingFrom && (pos.castling_rights() & QueenSide)
+            && (pos.pieces(Us, ROOK) & square_bb(relative_square(Us, SQ_A1)))
+            && !(pos.pieces() & (square_bb(relative_square(Us, SQ_B1)) | square_bb(relative_square(Us, SQ_C1))
+                                   | square_bb(relative_square(Us, SQ_D1))))
+            && safe(relative_square(Us, SQ_D1)) && safe(relative_square(Us, SQ_C1)))
+            *list++ = Move(KingFrom, relative_square(Us, SQ_C1), NONE, Move::CASTLING);
+    }
+    return list;
+}
+
+// 'ci' is only read by QUIET_CHECKS and may be null for every other type
+template <Color Us, GenType Type>
+Move* generate_all(const Board& pos, Move* list, const CheckInfo* ci) {
+    constexpr Color Them = ~Us;
+    const LegalMasks m = legal_masks<Us>(pos);
+
+    assert(Type != EVASIONS || m.checkers);
+    assert(Type != QUIET_CHECKS || !m.checkers);
+
+    const Bitboard target = Type == CAPTURES ? pos.pieces(Them)
+                          : Type == QUIETS || Type == QUIET_CHECKS ? ~pos.pieces()
+                          : ~pos.pieces(Us);
+
+    // In double check only the king can move
+    if (!more_than_one(m.checkers)) {
+        const Bitboard pieceTarget = target & m.checkMask;
+        list = generate_pawn_moves<Us, Type>(pos, list, m, ci);
+        list = generate_piece_moves<Us, KNIGHT, Type>(pos, list, m, ci, pieceTarget);
+        list = generate_piece_moves<Us, BISHOP, Type>(pos, list, m, ci, pieceTarget);
+        list = generate_piece_moves<Us, ROOK,   Type>(pos, list, m, ci, pieceTarget);
+        list = generate_piece_moves<Us, QUEEN,  Type>(pos, list, m, ci, pieceTarget);
+    }
+    return generate_king_moves<Us, Type>(pos, list, m, ci, target);
+}
+
+} // namespace
+
+Move* generate_quiet_checks(const Board& pos, Move* moveList, const CheckInfo& ci) {
+    return pos.side_to_move() == WHITE ? generate_all<WHITE, QUIET_CHECKS>(pos, moveList, &ci)
+                                   : generate_all<BLACK, QUIET_CHECKS>(pos, moveList, &ci);
+}
+
+template <GenType Type>
+Move* generate(const Board& pos, Move* moveList) {
+    if (Type == QUIET_CHECKS)
+        return generate_quiet_checks(pos, moveList, CheckInfo(pos));
+    return pos.side_to_move() == WHITE ? generate_all<WHITE, Type>(pos, moveList, nullptr)
+                                   : generate_all<BLACK, Type>(pos, moveList, nullptr);
+}
+
+Move parse_move(const Board& pos, const std::string& uci) {
+    MoveList<> moves;
+    generate<LEGAL>(pos, moves);
+    for (Move m : moves)
+        if (m.to_uci() == uci)
+            return m;
+    return Move::none();
+}
+
+// Explicit instantiations
+template Move* generate<CAPTURES>(const Board&, Move*);
+template Move* generate<QUIETS>(const Board&, Move*);
+template Move* generate<EVASIONS>(const Board&, Move*);
+template Move* generate<QUIET_CHECKS>(const Board&, Move*);
+template Move* generate<LEGAL>(const Board&, Move*);
+
@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include "board.h"
+#include "move.h"
+
+// Which subset of the legal moves to generate
+enum GenType {
+    CAPTURES,      // Captures, en passant and queen push-promotions
+    QUIETS,        // Non-captures: pushes, castling, underpromotion pushes
+    EVASIONS,      // All legal moves while in check
+    QUIET_CHECKS,  // QUIETS that give check (not in check, promotions excluded)
+    LEGAL          // All legal moves
+};
+
+struct ScoredMove {
+    Move move;
+    int score;
+    bool operator<(const ScoredMove& other) const { return score > other.score; }
+};
+
+// Fixed-capacity list with inline storage: lives on the stack, never allocates.
+// MAX_MOVES covers the largest legal move count of any reachable position (218).
+template <typename T, std::size_t N>
+class FixedList {
+public:
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear() { size_ = 0; }
+
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+
+    void push_back(const T& v) {
+        assert(size_ < N);
+        data_[size_++] = v;
+    }
+    bool contains(const T& v) const { return std::find(begin(), end(), v) != end(); }
+
+    // Let a generator write directly past the last element
+    T* tail() { return end(); }
+    void set_tail(T* p) {
+        assert(p >= data_ && p <= data_ + N);
+        size_ = std::size_t(p - data_);
+    }
+
+private:
+    T data_[N];
+    std::size_t size_ = 0;
+};
+
+template <std::size_t N = MAX_MOVES>
+using MoveList = FixedList<Move, N>;
+using ScoredMoveList = FixedList<ScoredMove, MAX_MOVES>;
+
+// Every generator emits legal moves only. The check mask and the pin rays are
+// computed once per call, so no move needs a make/test/unmake round trip.
+// CAPTURES + QUIETS together are exactly the LEGAL moves.
+template <GenType Type>
+Move* generate(const Board& pos, Move* moveList);
+
+// Appends to the list, so e.g. CAPTURES then QUIET_CHECKS can share one list
+template <GenType Type, std::size_t N>
+void generate(const Board& pos, MoveList<N>& moves) {
+    static_assert(N >= std::size_t(MAX_MOVES), "generators write up to MAX_MOVES + 3 moves");
+    moves.set_tail(generate<Type>(pos, moves.tail()));
+}
+
+// QUIET_CHECKS reusing the CheckInfo the caller already built for this node
+Move* generate_quiet_checks(const Board& pos, Move* moveList, const CheckInfo& ci);
+
+template <std::size_t N>
+void generate_quiet_checks(const Board& pos, MoveList<N>& moves, const CheckInfo& ci) {
+    static_assert(N >= std::size_t(MAX_MOVES), "generators write up to MAX_MOVES + 3 moves");
+    moves.set_tail(generate_quiet_checks(pos, moves.tail(), ci));
+}
+
+template <std::size_t N>
+void generate_moves(const Board& pos, MoveList<N>& moves) {
+    generate<LEGAL>(pos, moves);
+}
+
+// Match UCI input against the legal moves, so en passant and castling get
+// their move type. Returns Move::none() if the move is not legal here.
+Move parse_move(const Board& pos, const std::string& uci);
@@ -1,92 +1,197 @@
 #include "moveorder.h"
+#include "see.h"
 #include <algorithm>
 
-// Initialize static members
-int MoveOrder::history[2][64][64] = {};
-int MoveOrder::counterMoves[16][64] = {};
-std::vector<std::array<Move, 2>> MoveOrder::killers;
+namespace {
 
-void MoveOrder::init(const Board& board, const std::vector<Move>& moves, 
-                    Move pvMove, int ply, const Move* countermove) {
-    pos = &board;
-    this->pvMove = pvMove;
-    currentPly = ply;
-    if (countermove) this->countermove = *countermove;
-    
-    // Ensure killers vector is large enough
-    if (killers.size() <= static_cast<size_t>(ply)) {
-        killers.resize(ply + 1);
-    }
+constexpr int EvasionCaptureBonus = 1 << 20;  // Captures before quiet evasions
 
-    // Score and order moves
-    ordered.clear();
-    ordered.reserve(moves.size());
-    
-    for (Move m : moves) {
-        ordered.push_back({m, score_move(m)});
-    }
+// MVV-LVA (Most Valuable Victim - Least Valuable Attacker), promotion gain
+// counted as part of the victim
+int mvv_lva(const Board& pos, Move move) {
+    const PieceType victim = move.is_enpassant() ? PAWN : type_of(pos.piece_on(move.to()));
+    int score = 16 * SEE::PieceValue[victim];
+    if (move.is_promotion())
+        score += 16 * (SEE::PieceValue[move.promotion_piece()] - SEE::PieceValue[PAWN]);
+    return score - type_of(pos.piece_on(move.from()));
+}
 
-    // Partial sort - first 5 moves are fully ordered
-    if (ordered.size() > 5) {
-        std::partial_sort(ordered.begin(), ordered.begin() + 5, 
-                         ordered.end());
-    } else {
-        std::sort(ordered.begin(), ordered.end());
-    }
+} // namespace
 
-    reset();
+void MoveOrder::Tables::clear() {
+    std::fill(&history[0][0][0], &history[0][0][0] + sizeof(history) / sizeof(int), 0);
+    std::fill(&counterMoves[0][0], &counterMoves[0][0] + PIECE_NB * MAX_SQUARES, Move::none());
+    clear_killers();
+    stats = {};
 }
 
-bool MoveOrder::next(Move& outMove) {
-    if (current == ordered.end()) return false;
-    outMove = current->move;
-    ++current;
-    return true;
+void MoveOrder::Tables::clear_killers() {
+    for (auto& k : killers)
+        k[0] = k[1] = Move::none();
 }
 
-int MoveOrder::score_move(Move move) const {
-    if (move == pvMove) return SCORE_PV;
-    if (pos->is_capture(move)) return score_capture(move);
-    return score_quiet(move);
+void MoveOrder::init(const Board& board, Move tt, int ply, const Move* countermove) {
+    assert(ply < MAX_PLY);
+    pos = &board;
+    currentPly = ply;
+    current = 0;
+    moves.clear();
+    badCaptures.clear();
+
+    // A TT move comes from a 16-bit key slice and may belong to another position
+    ttMove = tt.is_valid() && board.pseudo_legal(tt) && board.is_legal(tt) ? tt : Move::none();
+
+    refutations[0] = tables.killers[ply][0];
+    refutations[1] = tables.killers[ply][1];
+    refutations[2] = countermove ? *countermove : Move::none();
+
+    if (board.in_check())
+        stage = EVASION_TT_MOVE;
+    else {
+        stage = TT_MOVE;
+        ++tables.stats.pickers;
+    }
+    if (!ttMove.is_valid())
+        ++stage;
 }
 
-int MoveOrder::score_capture(Move move) const {
-    // MVV-LVA (Most Valuable Victim - Least Valuable Attacker)
-    int victim = pos->piece_on(move.to());
-    int attacker = pos->piece_on(move.from());
-    int score = SCORE_CAPTURE + 10 * victim - attacker;
+bool MoveOrder::next(Move& outMove) {
+    switch (stage) {
+    case TT_MOVE:
+    case EVASION_TT_MOVE:
+        ++stage;
+        ++tables.stats.ttMoves;
+        outMove = ttMove;
+        return true;
+
+    case CAPTURE_INIT: {
+        MoveList<> captures;
+        generate<CAPTURES>(*pos, captures);
+        for (Move m : captures)
+            moves.push_back({m, 0});
+        score_captures();
+        ++tables.stats.captureGenerations;
+        ++stage;
+        [[fallthrough]];
+    }
 
-    // SEE pruning
-    if (see_sign(move) < 0) {
-        return SCORE_BAD_CAPTURE + score;  // Bad captures go last
+    case GOOD_CAPTURE:
+        while (pick_best(outMove)) {
+            if (see_sign(outMove) >= 0)
+                return true;
+            badCaptures.push_back(outMove);
+        }
+        current = 0;
+        ++stage;
+        [[fallthrough]];
+
+    // Killers and the countermove are quiet moves from other nodes: they must
+    // be re-validated here and must not repeat the TT move, a capture or
+    // each other
+    case REFUTATION:
+        while (current < MAX_KILLERS + 1) {
+            Move* const seen = refutations + current;
+            const Move m = refutations[current++];
+            if (m.is_valid() && m != ttMove && std::find(refutations, seen, m) == seen
+                && !pos->is_capture(m) && m.promotion_piece() != QUEEN
+                && pos->pseudo_legal(m) && pos->is_legal(m)) {
+                outMove = m;
+                return true;
+            }
+        }
+        ++stage;
+        [[fallthrough]];
+
+    case QUIET_INIT: {
+        MoveList<> quiets;
+        generate<QUIETS>(*pos, quiets);
+        moves.clear();
+        for (Move m : quiets)
+            if (!is_refutation(m))
+                moves.push_back({m, 0});
+        score_quiets();
+        ++tables.stats.quietGenerations;
+        current = 0;
+        ++stage;
+        [[fallthrough]];
     }
-    return score;
-}
 
-int MoveOrder::score_quiet(Move move) const {
-    int score = 0;
-    
-    // Killer moves
-    for (int i = 0; i < MAX_KILLERS; ++i) {
-        if (move == killers[currentPly][i]) {
-            score += (i == 0) ? SCORE_KILLER1 : SCORE_KILLER2;
+    case QUIET:
+        if (pick_best(outMove))
+            return true;
+        current = 0;
+        ++stage;
+        [[fallthrough]];
+
+    case BAD_CAPTURE:
+        if (current < badCaptures.size()) {
+            outMove = badCaptures[current++];
+            return true;
         }
+        stage = DONE;
+        return false;
+
+    case EVASION_INIT: {
+        MoveList<> evasions;
+        generate<EVASIONS>(*pos, evasions);
+        for (Move m : evasions)
+            moves.push_back({m, 0});
+        score_evasions();
+        ++stage;
+        [[fallthrough]];
     }
 
-    // Countermove heuristic
-    if (move == countermove) {
-        score += SCORE_COUNTER;
+    case EVASION:
+        if (pick_best(outMove))
+            return true;
+        stage = DONE;
+        return false;
+
+    default:
+        return false;
     }
+}
 
-    // History heuristic
-    Color c = pos->side_to_move();
-    score += history[c][move.from()][move.to()] / 16;  // Scale down history
+void MoveOrder::score_captures() {
+    for (ScoredMove& sm : moves)
+        sm.score = mvv_lva(*pos, sm.move);
+}
+
+void MoveOrder::score_quiets() {
+    const Color c = pos->side_to_move();
+    for (ScoredMove& sm : moves)
+        sm.score = tables.history[c][sm.move.from()][sm.move.to()];
+}
+
+void MoveOrder::score_evasions() {
+    const Color c = pos->side_to_move();
+    for (ScoredMove& sm : moves)
+        sm.score = pos->is_capture(sm.move) ? EvasionCaptureBonus + mvv_lva(*pos, sm.move)
+                                            : tables.history[c][sm.move.from()][sm.move.to()];
+}
+
+// Selection rather than a sort: a cutoff usually comes after a few picks, so
+// the rest of the list is never ordered.
+bool MoveOrder::pick_best(Move& outMove) {
+    while (current < moves.size()) {
+        std::swap(moves[current], *std::max_element(moves.begin() + current, moves.end(),
+            [](const ScoredMove& a, const ScoredMove& b) { return a.score < b.score; }));
+        outMove = moves[current++].move;
+        if (outMove != ttMove)
+            return true;
+    }
+    return false;
+}
 
-    return score;
+// Already returned by the TT or refutation stage
+bool MoveOrder::is_refutation(Move move) const {
+    return move == ttMove
+        || std::find(refutations, refutations + MAX_KILLERS + 1, move) != refutations + MAX_KILLERS + 1;
 }
 
 void MoveOrder::update_history(Move move, int depth, int ply) {
     Color c = pos->side_to_move();
+    auto& history = tables.history;
     int bonus = std::min(16 * depth * depth, 1200);
     history[c][move.from()][move.to()] += bonus;
 
@@ -98,8 +203,18 @@ void MoveOrder::update_history(Move move, int depth, int ply) {
     }
 
     // Update killer moves
+    auto& killers = tables.killers;
     if (killers[ply][0] != move) {
         killers[ply][1] = killers[ply][0];
         killers[ply][0] = move;
     }
-}
\ No newline at end of file
+}
+
+// -1 if the capture loses material, 1 otherwise
+int MoveOrder::see_sign(Move move) const {
+    // Taking something at least as valuable as the capturer cannot lose
+    if (SEE::PieceValue[type_of(pos->piece_on(move.to()))]
+        >= SEE::PieceValue[type_of(pos->piece_on(move.from()))])
+        return 1;
+    return SEE::see_ge(*pos, move) ? 1 : -1;
+}
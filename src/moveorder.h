@@ -1,72 +1,81 @@
 #pragma once
-#include <vector>
-#include <array>
+#include <cstdint>
 #include "move.h"
 #include "board.h"
+#include "movegen.h"
 #include "types.h"  // For Value, Piece types
 
+// Staged move picker. Most cut nodes cut on the TT move or the first good
+// capture, so moves are produced one stage at a time and each stage is only
+// generated and scored once the previous one is exhausted:
+//   TT move -> good captures -> killers, countermove -> quiets -> bad captures
+// In check all evasions are generated at once after the TT move.
 class MoveOrder {
 public:
-    // Initialize with current position and search state
-    void init(const Board& board, const std::vector<Move>& moves, 
-              Move pvMove = Move::none(), int ply = 0, 
+    static constexpr int MAX_SQUARES = 64;
+    static constexpr int MAX_KILLERS = 2;
+
+    // How far pickers got, to measure how often quiet generation is skipped
+    struct Stats {
+        uint64_t pickers = 0;           // Pickers outside check
+        uint64_t ttMoves = 0;           // Valid TT moves returned
+        uint64_t captureGenerations = 0;
+        uint64_t quietGenerations = 0;
+    };
+
+    // What the pickers learn from cutoffs. Each search thread owns one set
+    // (see SearchWorker), so threads never write each other's tables.
+    struct Tables {
+        int history[COLOR_NB][MAX_SQUARES][MAX_SQUARES];  // [color][from][to]
+        Move counterMoves[PIECE_NB][MAX_SQUARES];         // [piece][to_square]
+        Move killers[MAX_PLY][MAX_KILLERS];               // Indexed by ply
+        Stats stats;
+
+        Tables() { clear(); }
+        void clear();          // Between games
+        void clear_killers();  // Between searches: plies refer to another root
+    };
+
+    explicit MoveOrder(Tables& t) : tables(t) {}
+
+    // Initialize with current position and search state. Nothing is
+    // generated yet; the TT move is only validated.
+    void init(const Board& board, Move ttMove = Move::none(), int ply = 0,
               const Move* countermove = nullptr);
 
     // Get next move in order (returns false when done)
     bool next(Move& outMove);
 
-    // Reset iterator without re-scoring
-    void reset() { current = ordered.begin(); }
-
     // Update history heuristics after a good move is found
     void update_history(Move move, int depth, int ply);
 
-    // Clear all history tables (between games)
-    static void clear_history();
+    const Stats& stats() const { return tables.stats; }
 
 private:
-    // Move scoring categories (adjust weights as needed)
-    enum Score {
-        SCORE_PV        = 20000,
-        SCORE_CAPTURE   = 15000,
-        SCORE_PROMO     = 10000,
-        SCORE_CASTLE    = 5000,
-        SCORE_KILLER1   = 9000,
-        SCORE_KILLER2   = 8000,
-        SCORE_COUNTER   = 7000,
-        SCORE_GOOD_SEE  = 6000,
-        SCORE_HISTORY   = 4000,
-        SCORE_BAD_CAPTURE = -1000
-    };
-
-    // Internal move entry with score
-    struct ScoredMove {
-        Move move;
-        int score;
-        bool operator<(const ScoredMove& other) const { return score > other.score; }
+    enum Stage {
+        TT_MOVE, CAPTURE_INIT, GOOD_CAPTURE, REFUTATION, QUIET_INIT, QUIET, BAD_CAPTURE,
+        EVASION_TT_MOVE, EVASION_INIT, EVASION,
+        DONE
     };
 
-    std::vector<ScoredMove> ordered;
-    std::vector<ScoredMove>::iterator current;
-
-    // History heuristics
-    static constexpr int MAX_SQUARES = 64;
-    static int history[2][MAX_SQUARES][MAX_SQUARES];  // [color][from][to]
-    static int counterMoves[16][MAX_SQUARES];         // [piece][to_square]
-    
-    // Killer moves (indexed by ply)
-    static constexpr int MAX_KILLERS = 2;
-    static std::vector<std::array<Move, MAX_KILLERS>> killers;
+    Tables& tables;
 
     // Current search state
     const Board* pos;
-    Move pvMove;
-    Move countermove;
+    Move ttMove;
+    Move refutations[MAX_KILLERS + 1];  // Killers, then the countermove
     int currentPly;
+    int stage;
+    std::size_t current;
+
+    ScoredMoveList moves;       // The stage being picked from
+    MoveList<> badCaptures;     // Captures that failed SEE, tried last
 
     // Scoring functions
-    int score_move(Move move) const;
-    int score_capture(Move move) const;
-    int score_quiet(Move move) const;
+    void score_captures();
+    void score_quiets();
+    void score_evasions();
+    bool pick_best(Move& outMove);  // Highest remaining score, skipping 'ttMove'
+    bool is_refutation(Move move) const;
     int see_sign(Move move) const;
-};
\ No newline at end of file
+};
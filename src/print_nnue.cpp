@@ -28,7 +28,7 @@ int main(int argc, char** argv) {
 
     // Optional: quick eval to prove it runs
     Board b;
-    b.set_from_fen("rn1qkbnr/ppp1pppp/8/3p4/3P4/5N2/PPP1PPPP/RNBQKB1R w KQkq - 1 3");
+    b.set_fen("rn1qkbnr/ppp1pppp/8/3p4/3P4/5N2/PPP1PPPP/RNBQKB1R w KQkq - 1 3");
     int cp = NNUE::evaluate(b);
     std::cout << "Eval(sample) = " << cp << " cp\n";
     return 0;
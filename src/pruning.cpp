@@ -9,7 +9,7 @@ bool Pruning::null_move_pruning(const Board& board, int depth, int beta) {
     if (depth < 3) return false;
 
     // Don't prune if in check or insufficient material
-    if (board.in_check(board.sideToMove)) return false;
+    if (board.in_check()) return false;
 
     // TODO: Add some heuristics based on static eval if desired
 
@@ -1,188 +1,501 @@
 #include "search.h"
 #include "movegen.h"
 #include "evaluation.h"
-#include "transposition.h"
-#include "pruning.h"
-#include "quiescence.h"
-#include "timer.h"
-#include "history.h"
+#include "eval/pawn.h"
+#include "see.h"
+#include "util/time.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
-#include <vector>
+#include <thread>
 
-namespace Search {
+using namespace Search;
+
+namespace {
 
-// Configuration constants
-constexpr int MAX_PLY = 64;
 constexpr int ASPIRATION_WINDOW = 50;
-constexpr int NULL_MOVE_R = 2; // Reduction for null move
-
-// Search state
-SearchLimits limits;
-SearchResult result;
-std::atomic<bool> stopFlag;
-HistoryStats history;
-CounterMoveStats counterMoves;
-KillerMoves killers[MAX_PLY];
-
-void think(Position& pos, const SearchLimits& lim) {
-    // Initialize search
+
+// ABDADA markers cost two atomic operations per move; below this depth the
+// subtrees are too small for a duplicate to matter
+constexpr int ABDADA_MIN_DEPTH = 3;
+
+// Lazy SMP depth diversification: helper i uses row (i - 1) % 20 and skips
+// depth d when (d + SkipPhase) / SkipSize is odd, so at any time the
+// helpers are spread over the next few depths instead of all on one
+constexpr int SkipSize[]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+constexpr int SkipPhase[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+// Mate scores go into the TT relative to the node, so an entry stays
+// correct when the same position is reached at another ply
+int value_to_tt(int v, int ply) {
+    return v >= VALUE_MATE_IN_MAX_PLY ? v + ply : v <= -VALUE_MATE_IN_MAX_PLY ? v - ply : v;
+}
+
+int value_from_tt(int v, int ply) {
+    if (v == VALUE_NONE)
+        return v;
+    return v >= VALUE_MATE_IN_MAX_PLY ? v - ply : v <= -VALUE_MATE_IN_MAX_PLY ? v + ply : v;
+}
+
+// MVV-LVA for the quiescence captures, captures first when in check
+int capture_score(const Board& pos, Move move) {
+    const PieceType victim = move.is_enpassant() ? PAWN : type_of(pos.piece_on(move.to()));
+    return 16 * SEE::PieceValue[victim] - type_of(pos.piece_on(move.from()));
+}
+
+// Counters have a single writer; a plain store avoids a locked add per node
+void bump(std::atomic<uint64_t>& c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* smp_mode_name(SmpMode mode) {
+    return mode == SmpMode::ABDADA ? "abdada" : "lazy";
+}
+
+bool parse_smp_mode(const std::string& name, SmpMode& mode) {
+    if (name == "lazy")
+        mode = SmpMode::LAZY;
+    else if (name == "abdada")
+        mode = SmpMode::ABDADA;
+    else {
+        std::cerr << "Unknown SMP mode: " << name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SearchingTable::clear() {
+    for (auto& slot : slots)
+        slot.store(0, std::memory_order_relaxed);
+}
+
+uint64_t SearchShared::nodes_searched() const {
+    uint64_t nodes = 0;
+    for (const SearchWorker* w : workers)
+        nodes += w->nodes();
+    return nodes;
+}
+
+void SearchShared::init(const Board& pos, const SearchLimits& lim) {
+    rootPos = pos;
     limits = lim;
-    result = SearchResult();
-    stopFlag = false;
-    Timer::reset();
-    nodes = 0;
-
-    // Aspiration window search
-    int bestScore = 0;
-    int alpha = -INFINITE;
-    int beta = INFINITE;
-    int depth = 1;
-
-    // Iterative deepening loop
-    while (depth <= limits.maxDepth && !stopFlag) {
-        // Adjust window after first iteration
-        if (depth >= 5) {
-            alpha = std::max(-INFINITE, bestScore - ASPIRATION_WINDOW);
-            beta = std::min(INFINITE, bestScore + ASPIRATION_WINDOW);
-        }
+    stop = false;
+    if (mode == SmpMode::ABDADA)
+        searching.clear();
+    startMs = Timer::now_ms();
+    optimumMs = maximumMs = 0;
+
+    // A fixed share of the clock per move, at most four times that when an
+    // iteration runs long, never more than 4/5 of what is left
+    const Color us = pos.side_to_move();
+    if (lim.movetime)
+        optimumMs = maximumMs = uint64_t(lim.movetime);
+    else if (lim.time[us] && !lim.infinite) {
+        const int movesToGo = lim.movesToGo ? std::min(lim.movesToGo, 40) : 40;
+        maximumMs = uint64_t(lim.time[us]) * 4 / 5;
+        optimumMs = std::min<uint64_t>(maximumMs, lim.time[us] / movesToGo + lim.inc[us] * 3 / 4);
+        maximumMs = std::min(maximumMs, optimumMs * 4);
+    }
+}
 
-        // Search with current depth
-        int score = alphaBeta<Root>(pos, depth, alpha, beta);
+SearchWorker::SearchWorker(size_t id, size_t node, SearchShared& s)
+    : threadId(id), numaNode(node), shared(s) {}
 
-        // Handle aspiration window failure
-        if (score <= alpha || score >= beta) {
-            alpha = -INFINITE;
-            beta = INFINITE;
-            continue;
-        }
+void SearchWorker::clear() {
+    tables.clear();
+}
 
-        // Update best score and PV
-        bestScore = score;
-        updatePV(depth);
+bool SearchWorker::skip_depth(int depth) const {
+    // ABDADA splits each iteration between the threads instead
+    if (is_main() || shared.mode == SmpMode::ABDADA)
+        return false;
+    const int row = int((threadId - 1) % 20);
+    return ((depth + shared.rootPos.fullmove_number() + SkipPhase[row]) / SkipSize[row]) % 2;
+}
 
-        // Send info to GUI
-        sendInfo(depth, bestScore, Timer::elapsed());
+void SearchWorker::start_searching() {
+    Board pos = shared.rootPos;
+    best = SearchResult();
+    tables.clear_killers();
+    nodeCount.store(0, std::memory_order_relaxed);
+    callsCount = 0;
+
+    for (int i = 0; i < MAX_PLY + 2; ++i) {
+        stack[i].ply = i - 1;
+        stack[i].currentMove = Move::none();
+        stack[i].pv[0] = Move::none();
+    }
+    Stack* ss = stack + 1;
+
+    // Any legal move beats none if the search is stopped at once
+    MoveList<> rootMoves;
+    generate<LEGAL>(pos, rootMoves);
+    if (rootMoves.size())
+        best.bestMove = rootMoves[0];
+    else
+        best.score = pos.in_check() ? -VALUE_MATE : VALUE_DRAW;
+
+    int score = 0;
+    for (int depth = 1; depth <= shared.limits.depth && rootMoves.size(); ++depth) {
+        if (shared.stop.load(std::memory_order_relaxed))
+            break;
+        if (skip_depth(depth))
+            continue;
 
-        // Check time and depth limits
-        if (Timer::isTimeUp() || depth == MAX_PLY) {
-            stopFlag = true;
+        // Aspiration window around the last score, widened on each failure
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -VALUE_INFINITE, beta = VALUE_INFINITE;
+        if (depth >= 5) {
+            alpha = std::max(score - delta, -VALUE_INFINITE);
+            beta  = std::min(score + delta, VALUE_INFINITE);
+        }
+        while (true) {
+            score = search<Root>(pos, ss, alpha, beta, depth);
+            if (shared.stop.load(std::memory_order_relaxed))
+                break;
+            if (score <= alpha) {
+                beta  = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -VALUE_INFINITE);
+            } else if (score >= beta)
+                beta = std::min(score + delta, VALUE_INFINITE);
+            else
+                break;
+            delta += delta / 2;
         }
 
-        depth++;
+        // An interrupted iteration is not trusted: keep the last complete one
+        if (shared.stop.load(std::memory_order_relaxed))
+            break;
+
+        best.depth = depth;
+        best.score = score;
+        best.bestMove = ss->pv[0];
+        // One allocation at most, when the line outgrows the last one
+        const Move* pvBegin = ss->pv;
+        const Move* pvEnd = pvBegin;
+        while (pvEnd->is_valid())
+            ++pvEnd;
+        best.pv.assign(pvBegin, pvEnd);
+
+        if (is_main()) {
+            print_info(depth, score);
+            if (shared.optimumMs && Timer::now_ms() - shared.startMs >= shared.optimumMs)
+                break;
+        }
     }
 
-    result.bestMove = rootMoves[0].move;
+    // The main worker ends the search for everyone; in infinite mode only
+    // after being told to
+    if (is_main()) {
+        while (shared.limits.infinite && !shared.stop.load(std::memory_order_relaxed))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        shared.stop = true;
+    }
 }
 
-template <NodeType node>
-int alphaBeta(Position& pos, int depth, int alpha, int beta, bool cutNode) {
-    // Check time and depth limits
-    if ((nodes & 1023) == 0 && checkTime()) {
-        stopFlag = true;
+bool SearchWorker::should_stop() {
+    if (is_main() && ++callsCount >= 1024) {
+        callsCount = 0;
+        check_time();
     }
-    nodes++;
+    return shared.stop.load(std::memory_order_relaxed);
+}
+
+void SearchWorker::check_time() {
+    if ((shared.maximumMs && Timer::now_ms() - shared.startMs >= shared.maximumMs)
+        || (shared.limits.nodes && shared.nodes_searched() >= shared.limits.nodes))
+        shared.stop = true;
+}
+
+void SearchWorker::update_pv(Stack* ss, Move move) {
+    Move* pv = ss->pv;
+    *pv++ = move;
+    for (const Move* child = (ss + 1)->pv; child->is_valid(); )
+        *pv++ = *child++;
+    *pv = Move::none();
+}
+
+void SearchWorker::print_info(int depth, int score) const {
+    if (!shared.limits.printInfo)
+        return;
+
+    const uint64_t elapsed = std::max<uint64_t>(1, Timer::now_ms() - shared.startMs);
+    const uint64_t nodes = shared.nodes_searched();
+    std::cout << "info depth " << depth << " score ";
+    if (std::abs(score) >= VALUE_MATE_IN_MAX_PLY)
+        std::cout << "mate " << (score > 0 ? VALUE_MATE - score + 1 : -VALUE_MATE - score) / 2;
+    else
+        std::cout << "cp " << score;
+    std::cout << " nodes " << nodes << " nps " << nodes * 1000 / elapsed
+              << " hashfull " << shared.tt->hashfull() << " time " << elapsed << " pv";
+    for (Move m : best.pv)
+        std::cout << " " << m.to_uci();
+    std::cout << std::endl;
+}
+
+template <NodeType node>
+int SearchWorker::search(Board& pos, Stack* ss, int alpha, int beta, int depth) {
+    constexpr bool pvNode = node != NonPV;
+    constexpr bool rootNode = node == Root;
 
     // Leaf nodes
-    if (depth <= 0) {
-        return quiescence<node>(pos, alpha, beta);
-    }
+    if (depth <= 0)
+        return qsearch<pvNode ? PV : NonPV>(pos, ss, alpha, beta);
 
-    // Draw detection
-    if (pos.isDraw()) {
+    bump(nodeCount);
+    if (pvNode)
+        ss->pv[0] = Move::none();
+    if (should_stop())
         return 0;
-    }
 
-    // TT lookup
-    TTEntry tt;
-    bool ttHit = TT.probe(pos.key(), tt);
-    if (ttHit && !node == Root && tt.depth >= depth) {
-        if (tt.bound == BOUND_EXACT)
-            return tt.score;
-        if (tt.bound == BOUND_LOWER)
-            alpha = std::max(alpha, tt.score);
-        else if (tt.bound == BOUND_UPPER)
-            beta = std::min(beta, tt.score);
+    const bool inCheck = pos.in_check();
+    if (!rootNode) {
+        // Draw detection; a reversible move back into an earlier position
+        // already guarantees a draw, one ply before the repetition itself
+        if (pos.is_draw(ss->ply))
+            return VALUE_DRAW;
+        if (alpha < VALUE_DRAW && pos.has_game_cycle(ss->ply)) {
+            alpha = VALUE_DRAW;
+            if (alpha >= beta)
+                return alpha;
+        }
+        if (ss->ply >= MAX_PLY - 1)
+            return inCheck ? VALUE_DRAW : int(Eval::evaluate(pos));
+
+        // Mate distance pruning
+        alpha = std::max(-VALUE_MATE + ss->ply, alpha);
+        beta  = std::min(VALUE_MATE - ss->ply - 1, beta);
         if (alpha >= beta)
-            return tt.score;
+            return alpha;
     }
 
-    // Null move pruning
-    if (node != PV && depth >= 3 && !pos.inCheck() && !ttHit) {
-        pos.doNullMove();
-        int reduction = depth >= 6 ? 4 : 3;
-        int score = -alphaBeta<NonPV>(pos, depth - 1 - reduction, -beta, -beta + 1);
-        pos.undoNullMove();
-        if (score >= beta)
-            return score;
+    // TT lookup; the table is shared by all workers, which is how they help
+    // each other
+    TranspositionTable& tt = *shared.tt;
+    const TTNode ttNode = pvNode ? TTNode::PV : TTNode::NON_PV;
+    TTData tte;
+    const bool ttHit = tt.probe(pos.key(), tte, ttNode);
+    const int ttValue = ttHit ? value_from_tt(tte.value, ss->ply) : VALUE_NONE;
+    const Move ttMove = ttHit ? tte.move : Move::none();
+    if (!pvNode && ttHit && tte.depth >= depth && ttValue != VALUE_NONE
+        && (tte.bound & (ttValue >= beta ? BOUND_LOWER : BOUND_UPPER))) {
+        tt.count_cutoff(ttNode);
+        return ttValue;
     }
 
-    // Generate and order moves
-    MoveList moves;
-    MovePicker mp(pos, moves, history, counterMoves, killers, depth, tt.move);
-    mp.scoreMoves();
+    // Static eval, cached in the TT entry
+    int staticEval = VALUE_NONE;
+    if (!inCheck) {
+        if (ttHit && tte.eval != VALUE_NONE)
+            staticEval = tte.eval;
+        else {
+            staticEval = Eval::evaluate(pos);
+            if (!ttHit)
+                tt.store(pos.key(), Move::none(), VALUE_NONE, staticEval, BOUND_NONE,
+                         DEPTH_UNSEARCHED, false);
+        }
+    }
+
+    // Null move pruning, not twice in a row and not without pieces (zugzwang)
+    const Color us = pos.side_to_move();
+    if (!pvNode && !inCheck && depth >= 3 && staticEval >= beta && pos.plies_from_null() > 0
+        && (pos.pieces(us) & ~pos.pieces(PAWN) & ~pos.pieces(KING))) {
+        const int reduction = depth >= 6 ? 4 : 3;
+        ss->currentMove = Move::none();
+        pos.make_null_move(ss->st);
+        const int value = -search<NonPV>(pos, ss + 1, -beta, -beta + 1, depth - 1 - reduction);
+        pos.unmake_null_move();
+        if (shared.stop.load(std::memory_order_relaxed))
+            return 0;
+        if (value >= beta)
+            return value >= VALUE_MATE_IN_MAX_PLY ? beta : value;
+    }
+
+    // Countermove slot of the move that led here
+    const Move prev = (ss - 1)->currentMove;
+    Move* const countermove = prev.is_valid()
+                            ? &tables.counterMoves[pos.piece_on(prev.to())][prev.to()] : nullptr;
 
-    // Search variables
-    int bestScore = -INFINITE;
-    Move bestMove = MOVE_NONE;
-    int legalMoves = 0;
-    bool raisedAlpha = false;
+    MoveOrder mp(tables);
+    mp.init(pos, ttMove, ss->ply, countermove);
+
+    int bestValue = -VALUE_INFINITE;
+    Move bestMove = Move::none();
+    int moveCount = 0;
+    Move move;
+
+    // ABDADA: after the first move (searched by everyone, as in YBWC), moves
+    // another thread is searching from this position wait until the end
+    const bool abdada = shared.mode == SmpMode::ABDADA && depth >= ABDADA_MIN_DEPTH;
+    SearchingTable& searching = shared.searching;
+    const Key key = pos.key();
+    MoveList<> deferred;
+    size_t deferredIdx = 0;
+    bool pickerDone = false;
 
     // Main move loop
-    for (int i = 0; i < moves.size(); i++) {
-        Move move = mp.nextMove();
-        if (!pos.makeMove(move)) {
+    while (true) {
+        if (!pickerDone && !mp.next(move))
+            pickerDone = true;
+        if (pickerDone) {
+            if (deferredIdx == deferred.size())
+                break;
+            move = deferred[deferredIdx++];
+        } else if (abdada && moveCount && searching.contains(key, move)) {
+            deferred.push_back(move);
             continue;
         }
 
-        legalMoves++;
-        int score;
-
-        // Late move reduction
-        if (legalMoves >= 4 && depth >= 3 && !pos.inCheck() && !move.isCapture()) {
-            int reduction = log(legalMoves) / log(2) - 1;
-            score = -alphaBeta<NonPV>(pos, depth - 1 - reduction, -alpha - 1, -alpha);
-        } else {
-            score = -alphaBeta<NonPV>(pos, depth - 1, -alpha - 1, -alpha);
+        ++moveCount;
+        const bool quiet = !pos.is_capture(move) && !move.is_promotion();
+
+        tt.prefetch(pos.key_after(move));
+        Pawn::prefetch(pos.pawn_key_after(move));
+        const bool marked = abdada && searching.mark(key, move);
+        ss->currentMove = move;
+        pos.make_move(move, ss->st);
+        const bool givesCheck = pos.in_check();
+
+        int value = 0;
+        if (moveCount >= 4 && depth >= 3 && !inCheck && quiet && !givesCheck) {
+            // Late move reduction, re-searched at full depth if it beats alpha
+            const int reduction = std::max(1, int(std::log2(moveCount)) - 1);
+            value = -search<NonPV>(pos, ss + 1, -alpha - 1, -alpha, depth - 1 - reduction);
+            if (value > alpha)
+                value = -search<NonPV>(pos, ss + 1, -alpha - 1, -alpha, depth - 1);
+        } else if (!pvNode || moveCount > 1)
+            value = -search<NonPV>(pos, ss + 1, -alpha - 1, -alpha, depth - 1);
+
+        // Full window for the first move and for PV moves that beat alpha
+        if (pvNode && (moveCount == 1 || (value > alpha && (rootNode || value < beta))))
+            value = -search<PV>(pos, ss + 1, -beta, -alpha, depth - 1);
+
+        pos.unmake_move();
+        if (marked)
+            searching.unmark(key, move);
+        if (shared.stop.load(std::memory_order_relaxed))
+            return 0;
+
+        if (value > bestValue) {
+            bestValue = value;
+            if (value > alpha) {
+                bestMove = move;
+                if (pvNode)
+                    update_pv(ss, move);
+                if (value >= beta) {
+                    if (quiet) {
+                        mp.update_history(move, depth, ss->ply);
+                        if (countermove)
+                            *countermove = move;
+                    }
+                    break;
+                }
+                alpha = value;
+            }
         }
+    }
 
-        // Full search if LMR failed high
-        if (score > alpha && (node == PV || score < beta)) {
-            score = -alphaBeta<node>(pos, depth - 1, -beta, -alpha);
-        }
+    if (!moveCount)
+        return inCheck ? -VALUE_MATE + ss->ply : VALUE_DRAW;
 
-        pos.undoMove(move);
+    const Bound bound = bestValue >= beta ? BOUND_LOWER
+                      : pvNode && bestMove.is_valid() ? BOUND_EXACT : BOUND_UPPER;
+    tt.store(pos.key(), bestMove, value_to_tt(bestValue, ss->ply), staticEval, bound, depth, pvNode);
+    return bestValue;
+}
 
-        if (score > bestScore) {
-            bestScore = score;
-            bestMove = move;
+template <NodeType node>
+int SearchWorker::qsearch(Board& pos, Stack* ss, int alpha, int beta) {
+    constexpr bool pvNode = node == PV;
 
-            if (score > alpha) {
-                alpha = score;
-                raisedAlpha = true;
+    bump(nodeCount);
+    if (pvNode)
+        ss->pv[0] = Move::none();
+    if (should_stop())
+        return 0;
 
-                if (node == PV) {
-                    updatePV(move);
-                }
+    if (pos.is_draw(ss->ply))
+        return VALUE_DRAW;
+    if (alpha < VALUE_DRAW && pos.has_game_cycle(ss->ply)) {
+        alpha = VALUE_DRAW;
+        if (alpha >= beta)
+            return alpha;
+    }
+    const bool inCheck = pos.in_check();
+    if (ss->ply >= MAX_PLY - 1)
+        return inCheck ? VALUE_DRAW : int(Eval::evaluate(pos));
+
+    TranspositionTable& tt = *shared.tt;
+    TTData tte;
+    const bool ttHit = tt.probe(pos.key(), tte, TTNode::QSEARCH);
+    const int ttValue = ttHit ? value_from_tt(tte.value, ss->ply) : VALUE_NONE;
+    if (!pvNode && ttHit && tte.depth >= 0 && ttValue != VALUE_NONE
+        && (tte.bound & (ttValue >= beta ? BOUND_LOWER : BOUND_UPPER))) {
+        tt.count_cutoff(TTNode::QSEARCH);
+        return ttValue;
+    }
 
-                if (score >= beta) {
-                    // Update history and killers
-                    if (!move.isCapture()) {
-                        history.update(pos.pieceOn(move.from()), move.to(), depth);
-                        killers[depth].update(move);
-                    }
+    // Stand pat, reusing the static eval cached in the TT
+    int bestValue = -VALUE_INFINITE;
+    int staticEval = VALUE_NONE;
+    if (!inCheck) {
+        staticEval = ttHit && tte.eval != VALUE_NONE ? tte.eval : int(Eval::evaluate(pos));
+        bestValue = staticEval;
+        if (bestValue >= beta) {
+            if (!ttHit)
+                tt.store(pos.key(), Move::none(), VALUE_NONE, staticEval, BOUND_NONE,
+                         DEPTH_UNSEARCHED, false);
+            return bestValue;
+        }
+        alpha = std::max(alpha, bestValue);
+    }
+
+    // Captures only, or every evasion when in check, best victim first
+    MoveList<> list;
+    if (inCheck)
+        generate<EVASIONS>(pos, list);
+    else
+        generate<CAPTURES>(pos, list);
+    ScoredMoveList moves;
+    for (Move m : list)
+        moves.push_back({ m, pos.is_capture(m) ? (1 << 16) + capture_score(pos, m) : 0 });
+    std::sort(moves.begin(), moves.end());
+
+    Move bestMove = Move::none();
+    for (const ScoredMove& sm : moves) {
+        const Move move = sm.move;
+        if (!inCheck && !SEE::see_ge(pos, move))
+            continue;
+
+        tt.prefetch(pos.key_after(move));
+        Pawn::prefetch(pos.pawn_key_after(move));
+        ss->currentMove = move;
+        pos.make_move(move, ss->st);
+        const int value = -qsearch<node>(pos, ss + 1, -beta, -alpha);
+        pos.unmake_move();
+        if (shared.stop.load(std::memory_order_relaxed))
+            return 0;
+
+        if (value > bestValue) {
+            bestValue = value;
+            if (value > alpha) {
+                bestMove = move;
+                if (pvNode)
+                    update_pv(ss, move);
+                if (value >= beta)
                     break;
-                }
+                alpha = value;
             }
         }
     }
 
-    // TT store
-    Bound bound = raisedAlpha ? BOUND_LOWER : BOUND_UPPER;
-    if (alpha >= beta) bound = BOUND_LOWER;
-    TT.store(pos.key(), bestScore, depth, bound, bestMove);
+    if (inCheck && moves.size() == 0)
+        return -VALUE_MATE + ss->ply;
 
-    return bestScore;
+    const Bound bound = bestValue >= beta ? BOUND_LOWER
+                      : pvNode && bestMove.is_valid() ? BOUND_EXACT : BOUND_UPPER;
+    tt.store(pos.key(), bestMove, value_to_tt(bestValue, ss->ply), staticEval, bound, 0, pvNode);
+    return bestValue;
 }
-
-} // namespace Search
\ No newline at end of file
@@ -1,57 +1,167 @@
 #ifndef SEARCH_H
 #define SEARCH_H
 
-#include "position.h"
-#include <move.h>
+#include "board.h"
+#include "move.h"
 #include "moveorder.h"
-#include "pruning.h"
-#include "quiescence.h"
-#include <vector>
+#include "tt.h"
 #include <atomic>
-#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 // Search parameters (depth, time control, nodes, etc.)
 struct SearchLimits {
-    int depth;                  // Maximum search depth
-    int movetime;               // Fixed time per move (ms)
-    int time[2];                // Remaining time for both sides
-    int inc[2];                 // Increment per move
-    int movesToGo;              // Moves to next time control
-    bool infinite;              // Search until stopped
+    int depth = MAX_PLY - 1;     // Maximum search depth
+    int movetime = 0;            // Fixed time per move (ms), 0 if none
+    int time[COLOR_NB] = {};     // Remaining time for both sides (ms)
+    int inc[COLOR_NB] = {};      // Increment per move (ms)
+    int movesToGo = 0;           // Moves to next time control, 0 if sudden death
+    uint64_t nodes = 0;          // Node budget over all threads, 0 if none
+    bool infinite = false;       // Search until stopped
+    bool printInfo = true;       // UCI "info" lines from the main thread
 };
 
 // Search results (best move, score, PV line)
 struct SearchResult {
     Move bestMove;
-    int score;                  // in centipawns
-    std::vector<Move> pv;       // Principal variation
+    int score = 0;               // In centipawns, side to move
+    int depth = 0;               // Last completed iteration
+    std::vector<Move> pv;        // Principal variation
 };
 
-// Main search class
-class Search {
+enum NodeType { NonPV, PV, Root };
+
+namespace Search {
+
+constexpr int VALUE_DRAW     = 0;
+constexpr int VALUE_MATE     = 32000;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+} // namespace Search
+
+// How the threads of the pool share the work ("SMP Mode" option)
+enum class SmpMode {
+    LAZY,    // Independent searches that share the TT; helpers skip depths
+    ABDADA   // Same iteration everywhere; moves another thread is busy with are deferred
+};
+
+const char* smp_mode_name(SmpMode mode);
+bool parse_smp_mode(const std::string& name, SmpMode& mode);  // "lazy" or "abdada"
+
+// ABDADA's "currently searching" markers: (position, move) pairs that some
+// thread is in the middle of searching. Lossy and lock-free: a marker that
+// finds its slot taken is dropped, which only costs a duplicated subtree.
+// Every mark() that succeeds is undone by unmark() before the node returns,
+// so the table is empty between searches.
+class SearchingTable {
 public:
-    Search();
+    static constexpr size_t Size = 1 << 14;  // 128 KiB, fits in L2
 
-    void startSearch(Position& pos, const SearchLimits& limits);
-    void stopSearch();
+    bool contains(Key key, Move move) const {
+        const uint64_t t = tag(key, move);
+        return slots[t & (Size - 1)].load(std::memory_order_relaxed) == t;
+    }
+    // Returns whether this call owns the marker and must unmark it
+    bool mark(Key key, Move move) {
+        const uint64_t t = tag(key, move);
+        uint64_t empty = 0;
+        return slots[t & (Size - 1)].compare_exchange_strong(empty, t, std::memory_order_relaxed);
+    }
+    void unmark(Key key, Move move) {
+        const uint64_t t = tag(key, move);
+        slots[t & (Size - 1)].store(0, std::memory_order_relaxed);
+    }
+    void clear();
 
-    SearchResult getResult() const;
+private:
+    static uint64_t tag(Key key, Move move) {
+        const uint64_t t = key ^ (uint64_t(move.raw()) * 0x9E3779B97F4A7C15ULL);
+        return t ? t : 1;  // 0 marks an empty slot
+    }
+
+    std::atomic<uint64_t> slots[Size] = {};
+};
+
+class SearchWorker;
+namespace NNUE { struct Network; }
+
+// State of one search that all workers read: the root, the limits and the
+// stop flag. Only the main worker (id 0) decides when to stop; helpers
+// just watch the flag.
+struct SearchShared {
+    Board rootPos;
+    SearchLimits limits;
+    std::atomic<bool> stop{false};
+    SmpMode mode = SmpMode::LAZY;
+    SearchingTable searching;               // ABDADA markers, unused in LAZY mode
+    uint64_t startMs = 0;
+    uint64_t optimumMs = 0;                 // Don't start another iteration past this
+    uint64_t maximumMs = 0;                 // Hard limit, 0 if none
+    std::vector<const SearchWorker*> workers;  // For node totals
+    TranspositionTable* tt = nullptr;
+
+    void init(const Board& pos, const SearchLimits& limits);  // Clears stop, sets the time budget
+    uint64_t nodes_searched() const;
+};
+
+// Everything one search thread writes: its search stack, move ordering
+// tables and node counter. Every worker searches the whole tree from the
+// root and they cooperate through the shared TT (plus, in ABDADA mode, the
+// searching markers), so nothing here is shared and the worker is
+// cache-line aligned to keep neighbours from false sharing. In LAZY mode
+// helpers (id > 0) skip some iteration depths so that threads spread over
+// different depths instead of racing on the same one.
+class alignas(64) SearchWorker {
+public:
+    SearchWorker(size_t id, size_t numaNode, SearchShared& shared);
+
+    // Iterative deepening from shared.rootPos until the limits are reached
+    // or shared.stop is set. The main worker then sets shared.stop itself.
+    void start_searching();
+    void clear();  // New game: history and countermoves
+
+    size_t id() const { return threadId; }
+    size_t numa_node() const { return numaNode; }
+    // The NNUE weights replica on this worker's node, null without a network
+    const NNUE::Network* network() const { return net; }
+    void set_network(const NNUE::Network* n) { net = n; }
+    bool is_main() const { return threadId == 0; }
+    uint64_t nodes() const { return nodeCount.load(std::memory_order_relaxed); }
+    const SearchResult& result() const { return best; }
 
 private:
-    // Core alpha-beta search
-    int alphaBeta(Position& pos, int depth, int alpha, int beta, bool isRoot);
-    int quiescenceSearch(Position& pos, int alpha, int beta);
+    // Per-ply record; ss - 1 and ss + 1 are the parent and the child
+    struct Stack {
+        StateInfo st;            // Undo record of the move made at this ply
+        Move currentMove;
+        Move pv[MAX_PLY + 1];    // Principal variation from this ply, Move::none() terminated
+        int ply;
+    };
+
+    template <NodeType node>
+    int search(Board& pos, Stack* ss, int alpha, int beta, int depth);
+    template <NodeType node>
+    int qsearch(Board& pos, Stack* ss, int alpha, int beta);
 
-    // Time management
-    bool checkStop();
-    void initTime(const SearchLimits& limits);
+    bool skip_depth(int depth) const;
+    bool should_stop();
+    void check_time();
+    void print_info(int depth, int score) const;
+    static void update_pv(Stack* ss, Move move);
 
-    // Search state
-    std::atomic<bool> stopFlag;
-    std::chrono::steady_clock::time_point startTime;
-    int timeLimitMs;
+    // Written every node and summed by other threads: keep it on its own line
+    alignas(64) std::atomic<uint64_t> nodeCount{0};
+    int callsCount = 0;
 
-    SearchResult result;
+    const size_t threadId;
+    const size_t numaNode;
+    SearchShared& shared;
+    const NNUE::Network* net = nullptr;
+    MoveOrder::Tables tables;
+    SearchResult best;
+    Stack stack[MAX_PLY + 2];    // stack[0] is a sentinel before the root
 };
 
 #endif // SEARCH_H
@@ -0,0 +1,128 @@
+#include "see.h"
+#include "magic.h"
+#include <algorithm>
+
+namespace SEE {
+
+namespace {
+
+struct Exchange {
+    Square   to;
+    Bitboard occupied;   // Board after the move, for the x-ray rescans
+    int      victim;     // What the move wins, promotion gain included
+    int      attacker;   // What stands on 'to' afterwards
+};
+
+Exchange setup(const Board& pos, Move move) {
+    const Square from = Square(move.from()), to = Square(move.to());
+    Exchange e;
+    e.to = to;
+    e.occupied = pos.pieces() ^ square_bb(from);
+    e.victim = PieceValue[type_of(pos.piece_on(to))];
+    e.attacker = PieceValue[type_of(pos.piece_on(from))];
+
+    if (move.is_enpassant()) {
+        e.occupied ^= square_bb(to - pawn_push(pos.side_to_move()));
+        e.victim = PieceValue[PAWN];
+    } else if (move.is_promotion()) {
+        e.attacker = PieceValue[move.promotion_piece()];
+        e.victim += e.attacker - PieceValue[PAWN];
+    }
+    return e;
+}
+
+// Least valuable of 'stmAttackers', removed from 'occupied'. Sliders that
+// were behind it join 'attackers'.
+PieceType pop_least_valuable(const Board& pos, Square to, Bitboard stmAttackers,
+                             Bitboard& occupied, Bitboard& attackers) {
+    PieceType pt = PAWN;
+    Bitboard b;
+    while (!(b = stmAttackers & pos.pieces(pt)))
+        ++pt;
+
+    occupied ^= b & -b;
+    if (pt == PAWN || pt == BISHOP || pt == QUEEN)
+        attackers |= get_bishop_attacks(to, occupied) & (pos.pieces(BISHOP) | pos.pieces(QUEEN));
+    if (pt == ROOK || pt == QUEEN)
+        attackers |= get_rook_attacks(to, occupied) & (pos.pieces(ROOK) | pos.pieces(QUEEN));
+    attackers &= occupied;
+    return pt;
+}
+
+} // namespace
+
+int see(const Board& pos, Move move) {
+    if (move.is_castle())
+        return 0;
+
+    Exchange e = setup(pos, move);
+    Bitboard attackers = pos.attackers_to(e.to, e.occupied) & e.occupied;
+    Color stm = ~pos.side_to_move();
+
+    // gain[d]: what the side making capture d nets if the sequence stops there
+    int gain[32];
+    int d = 0;
+    gain[0] = e.victim;
+    int nextVictim = e.attacker;
+
+    while (const Bitboard stmAttackers = attackers & pos.pieces(stm)) {
+        // The king may only capture when nothing can take it back
+        if (!(stmAttackers & ~pos.pieces(KING)) && (attackers & pos.pieces(~stm)))
+            break;
+
+        ++d;
+        gain[d] = nextVictim - gain[d - 1];
+        nextVictim = PieceValue[pop_least_valuable(pos, e.to, stmAttackers, e.occupied, attackers)];
+        stm = ~stm;
+    }
+
+    // Each side takes the better of recapturing or standing pat
+    while (d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        --d;
+    }
+    return gain[0];
+}
+
+bool see_ge(const Board& pos, Move move, int threshold) {
+    if (move.is_castle())
+        return 0 >= threshold;
+
+    Exchange e = setup(pos, move);
+
+    // Even a free capture falls short
+    int swap = e.victim - threshold;
+    if (swap < 0)
+        return false;
+
+    // Still ahead after losing the capturing piece
+    swap = e.attacker - swap;
+    if (swap <= 0)
+        return true;
+
+    Bitboard attackers = pos.attackers_to(e.to, e.occupied) & e.occupied;
+    Color stm = pos.side_to_move();
+    bool result = true;
+
+    while (true) {
+        stm = ~stm;
+        const Bitboard stmAttackers = attackers & pos.pieces(stm);
+        if (!stmAttackers)
+            break;
+
+        // A king capture stands only if the other side has nothing left
+        if (!(stmAttackers & ~pos.pieces(KING)))
+            return (attackers & pos.pieces(~stm)) ? result : !result;
+
+        result = !result;
+        const PieceType pt = pop_least_valuable(pos, e.to, stmAttackers, e.occupied, attackers);
+
+        // 'swap' is what the side that just captured must win back
+        swap = PieceValue[pt] - swap;
+        if (swap < int(result))
+            break;
+    }
+    return result;
+}
+
+} // namespace SEE
@@ -0,0 +1,21 @@
+#pragma once
+#include "types.h"
+#include "move.h"
+#include "board.h"
+
+// Static exchange evaluation: the material balance of the capture sequence
+// on a move's destination square, each side always recapturing with its
+// least valuable attacker and free to stop when continuing would lose.
+namespace SEE {
+
+// Exchange values; the king is only ever the last capturer
+constexpr int PieceValue[PIECE_TYPE_NB] = { 0, 100, 320, 330, 500, 900, 0 };
+
+// Exact result in centipawns for the side to move (castling scores 0)
+int see(const Board& pos, Move move);
+
+// True if see(pos, move) >= threshold. Stops as soon as the answer is known,
+// so it is the form to use for ordering and pruning.
+bool see_ge(const Board& pos, Move move, int threshold = 0);
+
+} // namespace SEE
@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "bitboard.h"
+#include "move.h"
+
+#if defined(__AVX512VBMI2__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#define HAS_VPCOMPRESS 1
+#endif
+#if defined(__BMI__)
+#include <immintrin.h>
+#define HAS_BMI 1
+#endif
+
+// Bulk move serialization: one call turns a whole target bitboard into
+// NORMAL moves at the list tail. Every move is
+//     raw = to * 64 + from        (piece moves, one fixed origin)
+//     raw = to * 65 - D           (pawn moves, from = to - D)
+// so a single multiply-add per target square is enough.
+//  - SCALAR: pop_lsb + Move(from, to), the reference the others must match
+//  - BMI:    exact-count loop unrolled by four on tzcnt/blsr
+//  - AVX512: all 32 candidate moves of a half-board are built at once, then
+//            VPCOMPRESSW keeps the targeted ones for a single masked store
+// Unlike the magic backend, the choice is made at compile time: all paths
+// are correct and the fastest available one is fixed by the target ISA.
+namespace Serialize {
+
+enum class Backend : uint8_t { SCALAR, BMI, AVX512 };
+
+constexpr Backend Best =
+#if defined(HAS_VPCOMPRESS)
+    Backend::AVX512;
+#elif defined(HAS_BMI)
+    Backend::BMI;
+#else
+    Backend::SCALAR;
+#endif
+
+constexpr const char* backend_name(Backend b) {
+    return b == Backend::AVX512 ? "avx512" : b == Backend::BMI ? "bmi" : "scalar";
+}
+
+namespace detail {
+
+#ifdef HAS_BMI
+inline Move* splat_bmi(Move* list, Bitboard b, int mul, int add) {
+    // Groups of four with no per-move branch. The last group may write up to
+    // three junk moves past the end; see the slack note on piece_moves().
+    Move* const end = list + popcount(b);
+    for (; list < end; list += 4) {
+        const int t0 = int(_tzcnt_u64(b)); b = _blsr_u64(b);
+        const int t1 = int(_tzcnt_u64(b)); b = _blsr_u64(b);
+        const int t2 = int(_tzcnt_u64(b)); b = _blsr_u64(b);
+        const int t3 = int(_tzcnt_u64(b)); b = _blsr_u64(b);
+        list[0] = Move(uint16_t(t0 * mul + add));
+        list[1] = Move(uint16_t(t1 * mul + add));
+        list[2] = Move(uint16_t(t2 * mul + add));
+        list[3] = Move(uint16_t(t3 * mul + add));
+    }
+    return end;
+}
+#endif
+
+#ifdef HAS_VPCOMPRESS
+inline constexpr auto SquareIndex = [] {
+    std::array<uint16_t, 32> a{};
+    for (int i = 0; i < 32; ++i)
+        a[i] = uint16_t(i);
+    return a;
+}();
+
+inline Move* splat_avx512(Move* list, Bitboard b, int mul, int add) {
+    // Move is a 16-bit wrapper, so the list is a uint16_t array underneath
+    static_assert(sizeof(Move) == sizeof(uint16_t), "Move must stay 16 bits");
+
+    const __m512i squares = _mm512_loadu_si512(SquareIndex.data());
+    const __m512i vmul    = _mm512_set1_epi16(int16_t(mul));
+    for (int half = 0; half < 2; ++half) {
+        const __mmask32 m = __mmask32(b >> (32 * half));
+        if (!m)
+            continue;
+        // All 32 candidate moves of this half-board, then keep the set ones
+        const __m512i vadd = _mm512_set1_epi16(int16_t(add + 32 * half * mul));
+        const __m512i raw  = _mm512_add_epi16(_mm512_mullo_epi16(squares, vmul), vadd);
+        const int     n    = popcount(m);
+        _mm512_mask_storeu_epi16(list, __mmask32(n == 32 ? ~0u : (1u << n) - 1),
+                                 _mm512_maskz_compress_epi16(m, raw));
+        list += n;
+    }
+    return list;
+}
+#endif
+
+template <Backend B>
+inline Move* splat(Move* list, Bitboard b, int mul, int add) {
+#ifdef HAS_VPCOMPRESS
+    if constexpr (B == Backend::AVX512)
+        return splat_avx512(list, b, mul, add);
+#endif
+#ifdef HAS_BMI
+    if constexpr (B == Backend::BMI)
+        return splat_bmi(list, b, mul, add);
+#endif
+    while (b) {
+        const int to = pop_lsb(b);
+        *list++ = Move(uint16_t(to * mul + add));
+    }
+    return list;
+}
+
+} // namespace detail
+
+// Every square in 'targets' as a move from 'from'. The BMI path may write
+// up to three junk moves past the returned end, so the output buffer needs
+// MAX_MOVES entries however few moves it will hold: no position has more
+// than 218 legal moves, which leaves the slack. The MoveList overloads of
+// generate() reject smaller lists at compile time.
+static_assert(MAX_MOVES >= 218 + 3, "MAX_MOVES needs slack for the BMI path");
+
+template <Backend B = Best>
+inline Move* piece_moves(Move* list, Square from, Bitboard targets) {
+    if constexpr (B == Backend::SCALAR) {
+        while (targets)
+            *list++ = Move(from, pop_lsb(targets));
+        return list;
+    }
+    return detail::splat<B>(list, targets, 64, from);
+}
+
+// Every square in 'targets' as a pawn move from to - D
+template <Direction D, Backend B = Best>
+inline Move* pawn_moves(Move* list, Bitboard targets) {
+    if constexpr (B == Backend::SCALAR) {
+        while (targets) {
+            const Square to = pop_lsb(targets);
+            *list++ = Move(to - D, to);
+        }
+        return list;
+    }
+    return detail::splat<B>(list, targets, 65, -int(D));
+}
+
+} // namespace Serialize
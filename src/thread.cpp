@@ -1,128 +1,154 @@
 #include "thread.h"
-#include "search.h"
-#include "tt.h"  // For shared hash table access
-#include <iostream>
-#include <sched.h>  // For CPU affinity
+#include <algorithm>
 
 ThreadPool Threads;
 
-Thread::Thread(size_t id) : 
-    id(id),
-    exit_flag(false), 
-    searching(false),
-    nodes_searched(0),
-    root_depth(0) 
-{
-    // Initialize thread-local data
-    history.clear();
-    std::fill(killers.begin(), killers.end(), Move::none());
+Thread::Thread(size_t id, size_t n, const Numa::Topology& topo, SearchShared& s)
+    : idx(id), node(n), topology(topo), shared(s) {
+    nativeThread = std::thread(&Thread::idle_loop, this);
+    wait_for_search_finished();
 }
 
 Thread::~Thread() {
-    stop();
-}
-
-void Thread::start() {
-    native_thread = std::thread(&Thread::idle_loop, this);
-    
-    // Set CPU affinity (Linux/MacOS)
-    #ifdef __linux__
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(id % std::thread::hardware_concurrency(), &cpuset);
-    pthread_setaffinity_np(native_thread.native_handle(), sizeof(cpu_set_t), &cpuset);
-    #endif
-}
-
-void Thread::stop() {
     {
         std::lock_guard<std::mutex> lock(mtx);
-        exit_flag = true;
-        searching = false;
+        exitFlag = true;
     }
     cv.notify_all();
-    if (native_thread.joinable()) {
-        native_thread.join();
-    }
+    if (nativeThread.joinable())
+        nativeThread.join();
 }
 
 void Thread::idle_loop() {
+    // Same node mapping as TranspositionTable::clear's slices, given this
+    // pool's topology
+    topology.bind_current_thread(node);
+    searchWorker = std::make_unique<SearchWorker>(idx, node, shared);
+
     while (true) {
         std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, [this]{ return searching || exit_flag; });
-        
-        if (exit_flag) break;
-        
-        // Release lock during search
-        lock.unlock();
-        
-        // Perform search
-        SearchResult result = Search::think(*root_pos, limits, *this);
-        
-        // Update global best move if needed
-        if (id == 0) {
-            std::lock_guard<std::mutex> result_lock(result_mutex);
-            if (result.depth > best_result.depth) {
-                best_result = result;
-            }
-        }
-        
-        // Mark search complete
-        lock.lock();
         searching = false;
-        cv.notify_one();  // Notify main thread
+        cv.notify_all();  // Wake wait_for_search_finished
+        cv.wait(lock, [this] { return searching || exitFlag; });
+        if (exitFlag)
+            return;
+        lock.unlock();
+
+        searchWorker->start_searching();
     }
 }
 
-void Thread::begin_search(Position* pos, const SearchLimits& lim) {
-    std::lock_guard<std::mutex> lock(mtx);
-    root_pos = pos;
-    limits = lim;
-    nodes_searched = 0;
-    searching = true;
-    cv.notify_one();
+void Thread::start_searching() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        searching = true;
+    }
+    cv.notify_all();
 }
 
-void ThreadPool::init(size_t num_threads) {
-    // Clear existing threads
-    stop_all();
-    
-    // Create new threads
-    for (size_t i = 0; i < num_threads; ++i) {
-        threads.emplace_back(std::make_unique<Thread>(i));
-        threads.back()->start();
-    }
-    
-    // Set main thread pointer
-    if (!threads.empty()) {
-        main_thread = threads[0].get();
-    }
+void Thread::wait_for_search_finished() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] { return !searching; });
 }
 
-void ThreadPool::stop_all() {
-    for (auto& thread : threads) {
-        thread->stop();
+void ThreadPool::set(size_t count, TranspositionTable& tt) {
+    if (!threads.empty()) {
+        stop();
+        wait_for_search_finished();
     }
     threads.clear();
+    shared.workers.clear();
+    shared.tt = &tt;
+
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(std::make_unique<Thread>(i, topology.node_of(i, count), topology, shared));
+        shared.workers.push_back(&threads.back()->worker());
+    }
+    assign_networks();
 }
 
-Thread& ThreadPool::get(size_t idx) {
-    return *threads.at(idx);  // bounds-checked access
+void ThreadPool::set_topology(const Numa::Topology& topo) {
+    const size_t count = threads.size();
+    TranspositionTable& tt = shared.tt ? *shared.tt : TT;
+    set(0, tt);  // The threads hold a reference to the topology
+    topology = topo;
+    set_network(networkSource);
+    set(count, tt);
 }
 
-// Statistics aggregation
-uint64_t ThreadPool::total_nodes() const {
-    uint64_t nodes = 0;
+void ThreadPool::set_network(const NNUE::Network* network) {
+    wait_for_search_finished();
+    networks.reset();
+    networkSource = network;
+    if (network)
+        networks = std::make_unique<NNUE::NetworkReplicas>(*network, topology);
+    assign_networks();
+}
+
+void ThreadPool::assign_networks() {
+    for (auto& thread : threads)
+        thread->worker().set_network(networks ? &networks->on_node(thread->numa_node()) : nullptr);
+}
+
+void ThreadPool::clear() {
+    wait_for_search_finished();
+    for (auto& thread : threads)
+        thread->worker().clear();
+}
+
+void ThreadPool::set_mode(SmpMode mode) {
+    wait_for_search_finished();
+    shared.mode = mode;
+}
+
+void ThreadPool::start_thinking(const Board& pos, const SearchLimits& limits) {
+    wait_for_search_finished();
+    shared.tt->newGeneration();
+    shared.init(pos, limits);
+    for (auto& thread : threads)
+        thread->start_searching();
+}
+
+void ThreadPool::wait_for_search_finished() {
+    for (auto& thread : threads)
+        thread->wait_for_search_finished();
+}
+
+const SearchWorker& ThreadPool::best_worker() const {
+    const SearchWorker* best = &threads.front()->worker();
+
+    int minScore = Search::VALUE_INFINITE;
+    for (const auto& thread : threads)
+        minScore = std::min(minScore, thread->worker().result().score);
+
+    // A handful of threads: a flat list of (move, votes) is enough
+    std::vector<std::pair<Move, int64_t>> votes;
+    auto votes_for = [&votes](Move m) -> int64_t& {
+        for (auto& v : votes)
+            if (v.first == m)
+                return v.second;
+        votes.emplace_back(m, 0);
+        return votes.back().second;
+    };
     for (const auto& thread : threads) {
-        nodes += thread->nodes_searched.load(std::memory_order_relaxed);
+        const SearchResult& r = thread->worker().result();
+        votes_for(r.bestMove) += int64_t(r.score - minScore + 14) * r.depth;
     }
-    return nodes;
-}
 
-// Main thread helper
-void ThreadPool::wait_for_search_finish() {
-    std::unique_lock<std::mutex> lock(main_thread->mtx);
-    main_thread->cv.wait(lock, [this]{
-        return !main_thread->searching.load(std::memory_order_acquire);
-    });
-}
\ No newline at end of file
+    for (const auto& thread : threads) {
+        const SearchWorker& w = thread->worker();
+        const SearchResult& r = w.result();
+        const SearchResult& b = best->result();
+
+        // A proven mate is taken as is; otherwise the most voted move, and
+        // among its threads the deepest
+        if (b.score >= Search::VALUE_MATE_IN_MAX_PLY) {
+            if (r.score > b.score)
+                best = &w;
+        } else if (r.score >= Search::VALUE_MATE_IN_MAX_PLY
+                   || votes_for(r.bestMove) > votes_for(b.bestMove)
+                   || (r.bestMove == b.bestMove && r.depth > b.depth))
+            best = &w;
+    }
+    return *best;
+}
@@ -1,113 +1,94 @@
 #pragma once
 #include <thread>
 #include <vector>
-#include <atomic>
+#include <memory>
 #include <condition_variable>
 #include <mutex>
 #include "search.h"
 #include "tt.h"  // For shared hash table access
+#include "eval/nnue/replicas.h"
+#include "util/numa.h"
 
+// One search thread. It sleeps in idle_loop between searches and owns its
+// SearchWorker, which it allocates itself after binding to the CPUs of its
+// NUMA node, so the worker's memory is first touched on that node.
 class Thread {
 public:
-    explicit Thread(size_t id) : 
-        id(id),
-        exit_flag(false),
-        searching(false),
-        node_count(0),
-        root_depth(0) {}
-    
-    ~Thread() {
-        exit_flag = true;
-        cv.notify_one();
-        if (native_thread.joinable())
-            native_thread.join();
-    }
-
-    void start() {
-        native_thread = std::thread(&Thread::idle_loop, this);
-    }
-
-    void idle_loop() {
-        while (!exit_flag) {
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, [this]{ return searching || exit_flag; });
-            
-            if (searching && !exit_flag) {
-                lock.unlock();
-                Search::think(*root_pos, limits);
-                searching = false;
-            }
-        }
-    }
-
-    void begin_search(Position* pos, const SearchLimits& lim) {
-        std::lock_guard<std::mutex> lock(mtx);
-        root_pos = pos;
-        limits = lim;
-        node_count = 0;
-        searching = true;
-        cv.notify_one();
-    }
-
-    void stop() {
-        searching = false;
-    }
-
-    // Thread synchronization
-    void wait_for_search_finish() {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, [this]{ return !searching; });
-    }
-
-    // Thread-local data
-    size_t id;
-    Position* root_pos;
-    SearchLimits limits;
-    std::atomic<uint64_t> node_count;
-    std::atomic<int> root_depth;
-    HistoryStats history;
-    CounterMoveStats counter_moves;
-    std::array<KillerMoves, Search::MAX_PLY> killers;
+    Thread(size_t id, size_t node, const Numa::Topology& topology, SearchShared& shared);
+    ~Thread();
+
+    void start_searching();
+    void wait_for_search_finished();
+
+    size_t id() const { return idx; }
+    size_t numa_node() const { return node; }
+    SearchWorker& worker() { return *searchWorker; }
+    const SearchWorker& worker() const { return *searchWorker; }
 
 private:
-    std::thread native_thread;
-    std::atomic<bool> exit_flag;
-    std::atomic<bool> searching;
-    std::condition_variable cv;
+    void idle_loop();
+
+    const size_t idx;
+    const size_t node;
+    const Numa::Topology& topology;
+    SearchShared& shared;
+    std::unique_ptr<SearchWorker> searchWorker;
+
     std::mutex mtx;
+    std::condition_variable cv;
+    bool exitFlag = false;
+    bool searching = true;  // Until idle_loop has built the worker
+    std::thread nativeThread;
 };
 
+// Every thread searches the same root, sharing the TT: Lazy SMP by default,
+// or ABDADA, where threads also defer moves others are searching. The main
+// thread (0) manages time and stops the others; the result is taken from
+// the thread the others vote for.
 class ThreadPool {
 public:
-    void init(size_t num_threads) {
-        threads.clear();
-        for (size_t i = 0; i < num_threads; ++i) {
-            threads.emplace_back(std::make_unique<Thread>(i));
-            threads.back()->start();
-        }
-        main_thread = threads[0].get();
-    }
-
-    void stop_all() {
-        for (auto& thread : threads)
-            thread->stop();
-    }
-
-    Thread& get(size_t idx) { return *threads.at(idx); }
-    Thread& main() { return *main_thread; }
-    size_t size() const { return threads.size(); }
+    ~ThreadPool() { set(0); }
+
+    // Recreates the threads; 'tt' is the table they will share
+    void set(size_t count, TranspositionTable& tt = TT);
+    void clear();  // New game: every worker's history
 
-    // Statistics
-    uint64_t total_nodes() const {
-        uint64_t nodes = 0;
-        for (const auto& thread : threads)
-            nodes += thread->node_count.load();
-        return nodes;
-    }
+    // "SMP Mode" option; takes effect from the next search
+    void set_mode(SmpMode mode);
+    SmpMode mode() const { return shared.mode; }
+
+    // Threads are spread over the nodes of 'topo' (by default the detected
+    // one) and recreated on it, with the network replicated anew
+    void set_topology(const Numa::Topology& topo);
+    const Numa::Topology& numa_topology() const { return topology; }
+
+    // Replicates 'network' once per NUMA node and hands every worker its
+    // node's copy; null drops the replicas. 'network' must outlive the pool
+    // or the next call.
+    void set_network(const NNUE::Network* network);
+
+    // Starts a search in the background; wait_for_search_finished() joins it
+    void start_thinking(const Board& pos, const SearchLimits& limits);
+    void stop() { shared.stop = true; }
+    void wait_for_search_finished();
+
+    // Votes for each thread's best move, weighted by its completed depth and
+    // by how far its score is above the worst one. Call after the search.
+    const SearchWorker& best_worker() const;
+    SearchResult result() const { return best_worker().result(); }
+
+    uint64_t nodes_searched() const { return shared.nodes_searched(); }
+    size_t size() const { return threads.size(); }
+    Thread& main() { return *threads.front(); }
 
 private:
+    void assign_networks();
+
+    SearchShared shared;
+    Numa::Topology topology = Numa::Topology::system();
+    const NNUE::Network* networkSource = nullptr;
+    std::unique_ptr<NNUE::NetworkReplicas> networks;
     std::vector<std::unique_ptr<Thread>> threads;
-    Thread* main_thread;
 };
 
-extern ThreadPool Threads;
\ No newline at end of file
+extern ThreadPool Threads;
@@ -1,96 +1,818 @@
 #include "tt.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 TranspositionTable TT;
 
-TranspositionTable::TranspositionTable() : 
-    table(nullptr), numEntries(0), generation(0) {}
+namespace {
+
+// Runs fn(start, end) over 'count' items split into 'threadCount' slices.
+// With a topology, slice idx runs on the NUMA node it gives search worker
+// idx (same mapping as Thread::idle_loop), so pages it touches first are
+// placed on that node. Helper threads are used, leaving the caller's
+// affinity alone.
+template <typename Fn>
+void for_each_slice(size_t count, size_t threadCount, const Numa::Topology* topo, Fn fn) {
+    threadCount = std::max<size_t>(1, std::min(threadCount, count));
+    if (threadCount == 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t idx = 0; idx < threadCount; ++idx)
+        workers.emplace_back([=] {
+            if (topo)
+                topo->bind_current_thread(topo->node_of(idx, threadCount));
+            const size_t stride = count / threadCount;
+            fn(stride * idx, idx + 1 == threadCount ? count : stride * (idx + 1));
+        });
+    for (std::thread& t : workers)
+        t.join();
+}
+
+// floor(i * num / den) without overflow
+size_t scale(size_t i, size_t num, size_t den) {
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    return size_t(uint128(i) * num / den);
+#else
+    return size_t((long double)i * num / den);
+#endif
+}
+
+// Snapshot header, at the start of a SnapshotHeaderSize block
+struct SnapshotHeader {
+    char     magic[8];       // "TTSNAP\0\0"
+    uint32_t format;         // Bumped whenever TTEntry or Cluster layout changes
+    uint32_t clusterBytes;
+    uint64_t keySchema;      // Fingerprint of the Zobrist keys the entries were made with
+    uint64_t clusterCount;
+    uint64_t checksum;       // Over the cluster array, see TranspositionTable::checksum
+    uint8_t  generation8;
+};
+
+constexpr char     SnapshotMagic[8] = { 'T', 'T', 'S', 'N', 'A', 'P', 0, 0 };
+constexpr uint32_t SnapshotFormat   = 1;
+
+constexpr uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+constexpr uint64_t key_schema() {
+    uint64_t h = 0;
+    for (const auto& squares : Zobrist::Keys.piece)
+        for (Key k : squares)
+            h = mix(h ^ k);
+    for (Key k : Zobrist::Keys.castling)
+        h = mix(h ^ k);
+    for (Key k : Zobrist::Keys.enpassant)
+        h = mix(h ^ k);
+    return mix(h ^ Zobrist::Keys.side);
+}
+
+constexpr char     SegmentMagic[8] = { 'T', 'T', 'S', 'H', 'M', 0, 0, 0 };
+constexpr uint32_t SegmentFormat    = 2;
+constexpr uint32_t SegmentReady     = 1;
+constexpr int      MaxSharedProcesses = 1024;
+
+int32_t current_pid() {
+#if defined(__unix__) || defined(__APPLE__)
+    return int32_t(getpid());
+#else
+    return 1;
+#endif
+}
+
+// Signal 0 only checks the pid; EPERM means it exists under another user.
+// A recycled pid reads as alive, which at worst keeps a segment around.
+bool process_alive(int32_t pid) {
+#if defined(__unix__) || defined(__APPLE__)
+    return kill(pid_t(pid), 0) == 0 || errno == EPERM;
+#else
+    (void)pid;
+    return true;
+#endif
+}
+
+std::atomic<uint64_t> nextInstanceId{1};
+
+// Counters have a single writer, so a plain load and store is enough and
+// avoids a locked add on every probe
+void bump(std::atomic<uint64_t>& c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+constexpr const char* NodeNames[TT_NODE_NB]       = { "pv", "nonpv", "qsearch" };
+constexpr const char* ReplaceNames[TT_REPLACE_NB] = { "empty", "same_key", "same_key_kept",
+                                                      "aged", "depth", "busy" };
+
+std::string segment_path(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+} // namespace
+
+// Header at the start of a shared segment, padded to SegmentHeaderSize.
+// The creator fills it while 'state' is 0 and publishes it with SegmentReady.
+struct TranspositionTable::SharedSegment {
+    char     magic[8];       // "TTSHM\0\0\0"
+    uint32_t format;         // Bumped whenever TTEntry, Cluster or this header changes
+    uint32_t clusterBytes;
+    uint64_t keySchema;
+    uint64_t clusterCount;
+    std::atomic<uint32_t> state;
+    std::atomic<uint8_t>  generation8;
+    std::atomic<uint64_t> epochStart;  // steady_clock ms of the last advance, 0 = never
+    std::atomic<int32_t>  pids[MaxSharedProcesses];  // Attached processes, 0 = free slot
+
+    // Clears the first slot holding this process and the slots of dead
+    // processes. Returns whether any live process is still registered.
+    bool unregister(bool self) {
+        const int32_t me = current_pid();
+        bool live = false;
+        for (std::atomic<int32_t>& slot : pids) {
+            int32_t pid = slot.load(std::memory_order_relaxed);
+            if (!pid)
+                continue;
+            if ((self && pid == me) || !process_alive(pid)) {
+                if (pid == me)
+                    self = false;
+                slot.compare_exchange_strong(pid, 0);
+            } else
+                live = true;
+        }
+        return live;
+    }
+
+    bool register_self() {
+        for (std::atomic<int32_t>& slot : pids) {
+            int32_t expected = 0;
+            if (slot.compare_exchange_strong(expected, current_pid()))
+                return true;
+        }
+        return false;
+    }
+};
+
+bool TTEntry::save(Key k, int v, bool pv, Bound b, int d, Move m, int ev, uint8_t generation8) {
+    const uint16_t k16 = static_cast<uint16_t>(k);
+
+    // Keep the old move unless there is a new one or the position changed
+    if (m != Move::none() || k16 != key16)
+        move16 = m;
+
+    // Overwrite exact results, other positions, stale entries and anything
+    // not much shallower than what is stored (PV results get a bonus)
+    if (b == BOUND_EXACT || k16 != key16 || relative_age(generation8)
+        || d - DEPTH_ENTRY_OFFSET + 2 * pv > depth8 - 4) {
+        key16     = k16;
+        depth8    = static_cast<uint8_t>(d - DEPTH_ENTRY_OFFSET);
+        genBound8 = static_cast<uint8_t>(generation8 | uint8_t(pv) << 2 | b);
+        value16   = static_cast<int16_t>(v);
+        eval16    = static_cast<int16_t>(ev);
+        return true;
+    }
+    return false;
+}
+
+TranspositionTable::TranspositionTable() :
+    table(nullptr), clusterCount(0), pageMode(Memory::PageMode::NORMAL), generation8(0),
+    segment(nullptr), sharedGeneration(nullptr), statsEnabled(false),
+    instanceId(nextInstanceId++) {}
 
 TranspositionTable::~TranspositionTable() {
-    std::free(table);
+    free_table(table, clusterCount, pageMode);
+}
+
+void TranspositionTable::free_table(Cluster* t, size_t count, Memory::PageMode mode) {
+    if (mode != Memory::PageMode::SHARED) {
+        Memory::free_large(t, count * sizeof(Cluster), mode);
+        return;
+    }
+
+    if (sharedGeneration)
+        generation8 = sharedGeneration->load(std::memory_order_relaxed);
+    if (!segment->unregister(true))
+        Memory::unlink_shared(segmentName.c_str());
+    Memory::close_shared(segment, SegmentHeaderSize + count * sizeof(Cluster));
+    segment = nullptr;
+    sharedGeneration = nullptr;
+    segmentName.clear();
 }
 
-void TranspositionTable::resize(size_t mbSize) {
-    std::free(table);
-    numEntries = (mbSize * 1024 * 1024) / sizeof(Cluster);
-    table = static_cast<Cluster*>(std::calloc(numEntries, sizeof(Cluster)));
+void TranspositionTable::resize(size_t mbSize, size_t threadCount, bool tryHugeTlb,
+                                const Numa::Topology& topology) {
+    free_table(table, clusterCount, pageMode);
+    clusterCount = (mbSize * 1024 * 1024) / sizeof(Cluster);
+    table = static_cast<Cluster*>(Memory::alloc_large(clusterCount * sizeof(Cluster),
+                                                      tryHugeTlb, pageMode));
     if (!table) {
         std::cerr << "Failed to allocate " << mbSize << "MB for transposition table\n";
-        numEntries = 0;
+        clusterCount = 0;
+        return;
     }
+
+    std::cout << "info string Hash " << mbSize << " MB with "
+              << Memory::page_mode_name(pageMode) << " pages" << std::endl;
+    clear(threadCount, topology);
+}
+
+void TranspositionTable::clear(size_t threadCount, const Numa::Topology& topology) {
+    if (!table)
+        return;
+
+    for_each_slice(clusterCount, threadCount, &topology, [this](size_t start, size_t end) {
+        std::memset(static_cast<void*>(&table[start]), 0, (end - start) * sizeof(Cluster));
+    });
 }
 
-void TranspositionTable::clear() {
-    if (table) {
-        std::memset(table, 0, numEntries * sizeof(Cluster));
+void TranspositionTable::rehash(size_t mbSize, size_t threadCount, bool tryHugeTlb,
+                                const Numa::Topology& topology) {
+    if (!table) {
+        resize(mbSize, threadCount, tryHugeTlb, topology);
+        return;
+    }
+
+    const size_t newCount = (mbSize * 1024 * 1024) / sizeof(Cluster);
+    Memory::PageMode newMode;
+    Cluster* newTable = static_cast<Cluster*>(Memory::alloc_large(newCount * sizeof(Cluster),
+                                                                  tryHugeTlb, newMode));
+    if (!newTable || !newCount) {
+        std::cerr << "Failed to allocate " << mbSize << "MB for transposition table,"
+                  << " keeping the old one\n";
+        Memory::free_large(newTable, newCount * sizeof(Cluster), newMode);
+        return;
     }
+
+    // Only the low 16 key bits are stored, so an old entry's new cluster is
+    // known only as the range its old cluster's keys map onto. Each new
+    // cluster pulls every entry whose range covers it, keeping the best
+    // three by depth and age: growing copies an entry to all its candidate
+    // clusters (so every former hit still hits), shrinking merges. Clusters
+    // are rebuilt independently, so the slices need no synchronization.
+    const size_t oldCount = clusterCount;
+    for_each_slice(newCount, threadCount, &topology, [&](size_t start, size_t end) {
+        for (size_t j = start; j < end; ++j) {
+            Cluster& dst = newTable[j];
+            std::memset(static_cast<void*>(&dst), 0, sizeof(Cluster));
+
+            const size_t first = scale(j, oldCount, newCount);
+            const size_t last  = std::min(oldCount - 1, scale(j + 1, oldCount, newCount));
+            for (size_t i = first; i <= last; ++i) {
+                // Keys of old cluster i land in new clusters [lo, hi]
+                const size_t lo = scale(i, newCount, oldCount);
+                const size_t hi = std::min(newCount - 1, scale(i + 1, newCount, oldCount));
+                if (j < lo || j > hi)
+                    continue;
+                for (const TTEntry& e : table[i].entries)
+                    if (!e.empty())
+                        keep_best(dst, e);
+            }
+        }
+    });
+
+    free_table(table, clusterCount, pageMode);
+    table = newTable;
+    clusterCount = newCount;
+    pageMode = newMode;
+
+    std::cout << "info string Hash " << mbSize << " MB with "
+              << Memory::page_mode_name(pageMode) << " pages, entries kept" << std::endl;
+}
+
+bool TranspositionTable::attach_shared(const std::string& name, size_t mbSize) {
+    static_assert(sizeof(SharedSegment) <= SegmentHeaderSize, "Shared segment header does not fit");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free
+                  && std::atomic<uint8_t>::is_always_lock_free
+                  && std::atomic<uint64_t>::is_always_lock_free,
+                  "Atomics in shared memory must be lock-free to be address-free");
+
+    const std::string path = segment_path(name);
+    const size_t count = (mbSize * 1024 * 1024) / sizeof(Cluster);
+    if (!count) {
+        std::cerr << "Shared transposition table needs at least 1 MB\n";
+        return false;
+    }
+
+    // A segment whose creator died before publishing the header is removed
+    // and created afresh, once
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        size_t bytes = SegmentHeaderSize + count * sizeof(Cluster);
+        bool created = false;
+        void* mem = Memory::open_shared(path.c_str(), bytes, created);
+        if (!mem) {
+            std::cerr << "Cannot open shared transposition table " << path << "\n";
+            return false;
+        }
+        SharedSegment* s = static_cast<SharedSegment*>(mem);
+
+        if (created) {
+            // ftruncate zeroed the segment: every cluster is empty, state is 0
+            s->register_self();
+            std::memcpy(s->magic, SegmentMagic, sizeof(s->magic));
+            s->format       = SegmentFormat;
+            s->clusterBytes = sizeof(Cluster);
+            s->keySchema    = key_schema();
+            s->clusterCount = count;
+            s->generation8.store(generation8, std::memory_order_relaxed);
+            s->state.store(SegmentReady, std::memory_order_release);
+        } else {
+            for (int i = 0; i < 1000 && s->state.load(std::memory_order_acquire) != SegmentReady; ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            if (s->state.load(std::memory_order_acquire) != SegmentReady) {
+                const bool live = s->unregister(false);
+                Memory::close_shared(mem, bytes);
+                if (!live && attempt == 0) {
+                    Memory::unlink_shared(path.c_str());
+                    continue;
+                }
+                std::cerr << "Shared transposition table " << path << " was never initialized\n";
+                return false;
+            }
+            if (std::memcmp(s->magic, SegmentMagic, sizeof(s->magic)) || s->format != SegmentFormat
+                || s->clusterBytes != sizeof(Cluster) || s->keySchema != key_schema()
+                || bytes != SegmentHeaderSize + s->clusterCount * sizeof(Cluster)) {
+                std::cerr << path << " belongs to an incompatible engine version\n";
+                Memory::close_shared(mem, bytes);
+                return false;
+            }
+            s->unregister(false);
+            if (!s->register_self()) {
+                std::cerr << "Too many processes attached to " << path << "\n";
+                Memory::close_shared(mem, bytes);
+                return false;
+            }
+        }
+
+        free_table(table, clusterCount, pageMode);
+        table = reinterpret_cast<Cluster*>(static_cast<char*>(mem) + SegmentHeaderSize);
+        clusterCount = s->clusterCount;
+        pageMode = Memory::PageMode::SHARED;
+        segment = s;
+        sharedGeneration = &s->generation8;
+        segmentName = path;
+
+        std::cout << "info string Hash " << (clusterCount * sizeof(Cluster) >> 20) << " MB "
+                  << (created ? "created" : "attached") << " as shared segment " << path << std::endl;
+        return true;
+    }
+    return false;
+}
+
+// steady_clock is CLOCK_MONOTONIC, which all processes on the machine share.
+// The process whose CAS moves epochStart on owns the advance; the others
+// just pick up the current generation.
+void TranspositionTable::advance_shared_epoch() {
+    const uint64_t now = uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    uint64_t last = segment->epochStart.load(std::memory_order_relaxed);
+    if ((!last || now - last >= SharedEpochMs)
+        && segment->epochStart.compare_exchange_strong(last, now, std::memory_order_relaxed))
+        sharedGeneration->fetch_add(GENERATION_DELTA, std::memory_order_relaxed);
+    generation8 = sharedGeneration->load(std::memory_order_relaxed);
 }
 
-void TranspositionTable::newGeneration() {
-    generation++;
+void TranspositionTable::detach_shared() {
+    if (!is_shared())
+        return;
+    free_table(table, clusterCount, pageMode);
+    table = nullptr;
+    clusterCount = 0;
+    pageMode = Memory::PageMode::NORMAL;
 }
 
-TTEntry* TranspositionTable::probe(uint64_t key, bool& found) const {
-    if (numEntries == 0) {
-        found = false;
-        return nullptr;
+bool TranspositionTable::remove_stale_shared(const std::string& name) {
+    const std::string path = segment_path(name);
+    size_t bytes = 0;
+    bool created = false;
+    void* mem = Memory::open_shared(path.c_str(), bytes, created);
+    if (!mem)
+        return false;
+
+    const bool live = static_cast<SharedSegment*>(mem)->unregister(false);
+    Memory::close_shared(mem, bytes);
+    return !live && Memory::unlink_shared(path.c_str());
+}
+
+// Sum of mixed per-chunk hashes: independent of how the chunks are split
+// between threads, so save and load may use different thread counts
+uint64_t TranspositionTable::checksum(size_t threadCount, const Numa::Topology& topology) const {
+    constexpr size_t ChunkClusters = Memory::LargePageSize / sizeof(Cluster);
+    const size_t chunks = (clusterCount + ChunkClusters - 1) / ChunkClusters;
+    std::atomic<uint64_t> total{0};
+
+    for_each_slice(chunks, threadCount, &topology, [&](size_t start, size_t end) {
+        uint64_t sum = 0;
+        for (size_t c = start; c < end; ++c) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(&table[c * ChunkClusters]);
+            const size_t words = std::min(ChunkClusters, clusterCount - c * ChunkClusters)
+                               * sizeof(Cluster) / sizeof(uint64_t);
+            uint64_t h = c;
+            for (size_t w = 0; w < words; ++w) {
+                uint64_t v;
+                std::memcpy(&v, p + w * sizeof(uint64_t), sizeof(v));
+                h = (h ^ v) * 0x100000001B3ULL;
+            }
+            sum += mix(h);
+        }
+        total += sum;
+    });
+    return total;
+}
+
+bool TranspositionTable::save(const std::string& path, size_t threadCount,
+                              const Numa::Topology& topology) const {
+    if (!table) {
+        std::cerr << "No transposition table to save\n";
+        return false;
+    }
+
+    SnapshotHeader h{};
+    std::memcpy(h.magic, SnapshotMagic, sizeof(h.magic));
+    h.format       = SnapshotFormat;
+    h.clusterBytes = sizeof(Cluster);
+    h.keySchema    = key_schema();
+    h.clusterCount = clusterCount;
+    h.checksum     = checksum(threadCount, topology);
+    h.generation8  = generation();
+
+    std::vector<char> header(SnapshotHeaderSize, 0);
+    std::memcpy(header.data(), &h, sizeof(h));
+
+    // Write aside and rename: the table may be a mapping of 'path' itself,
+    // and truncating the file under it would fault. The renamed-over file
+    // lives on until it is unmapped.
+    const std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(header.data(), std::streamsize(header.size()));
+    out.write(reinterpret_cast<const char*>(table), std::streamsize(clusterCount * sizeof(Cluster)));
+    out.close();
+    if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write transposition table to " << path << "\n";
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    std::cout << "info string Saved " << (clusterCount * sizeof(Cluster) >> 20)
+              << " MB transposition table to " << path << std::endl;
+    return true;
+}
+
+bool TranspositionTable::load(const std::string& path, LoadPolicy policy,
+                              size_t threadCount, bool verify, const Numa::Topology& topology) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    const std::streamoff fileSize = in ? std::streamoff(in.tellg()) : -1;
+    SnapshotHeader h{};
+    in.seekg(0);
+    if (!in || !in.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+        std::cerr << "Cannot read transposition table snapshot " << path << "\n";
+        return false;
+    }
+
+    if (std::memcmp(h.magic, SnapshotMagic, sizeof(h.magic)) || h.format != SnapshotFormat
+        || h.clusterBytes != sizeof(Cluster) || h.keySchema != key_schema()) {
+        std::cerr << path << " was written by an incompatible engine version\n";
+        return false;
     }
 
-    Cluster& cluster = table[index(key)];
-    const uint16_t check = key16(key);
+    const size_t bytes = h.clusterCount * sizeof(Cluster);
+    if (!h.clusterCount || fileSize != std::streamoff(SnapshotHeaderSize + bytes)) {
+        std::cerr << path << " is truncated or has trailing data\n";
+        return false;
+    }
 
-    // Check all entries in cluster
-    for (int i = 0; i < 3; ++i) {
-        if (cluster.entries[i].key16 == check) {
-            found = true;
-            cluster.entries[i].generation = generation;
-            return &cluster.entries[i];
+    // Map the clusters in place; without mmap, read them into a fresh table
+    Memory::PageMode mode = Memory::PageMode::FILE_MAPPED;
+    Cluster* loaded = static_cast<Cluster*>(Memory::map_file(path.c_str(), SnapshotHeaderSize, bytes));
+    if (!loaded) {
+        loaded = static_cast<Cluster*>(Memory::alloc_large(bytes, false, mode));
+        in.seekg(std::streamoff(SnapshotHeaderSize));
+        if (!loaded || !in.read(reinterpret_cast<char*>(loaded), std::streamsize(bytes))) {
+            std::cerr << "Failed to read " << path << "\n";
+            Memory::free_large(loaded, bytes, mode);
+            return false;
         }
     }
 
-    found = false;
-    // Return the first entry as default replacement slot
-    return &cluster.entries[0];
+    // Swap in, keeping the old table until the snapshot is accepted
+    Cluster* const oldTable = table;
+    const size_t oldCount = clusterCount;
+    const Memory::PageMode oldMode = pageMode;
+    const uint8_t oldGeneration = generation8;
+    std::atomic<uint8_t>* const oldSharedGeneration = sharedGeneration;
+    table = loaded;
+    clusterCount = h.clusterCount;
+    pageMode = mode;
+    generation8 = h.generation8;
+    sharedGeneration = nullptr;
+
+    if (verify && checksum(threadCount, topology) != h.checksum) {
+        std::cerr << path << " failed its checksum, keeping the current table\n";
+        Memory::free_large(table, bytes, pageMode);
+        table = oldTable;
+        clusterCount = oldCount;
+        pageMode = oldMode;
+        generation8 = oldGeneration;
+        sharedGeneration = oldSharedGeneration;
+        return false;
+    }
+
+    std::cout << "info string Loaded " << (bytes >> 20) << " MB transposition table from "
+              << path << (verify ? ", checksum ok" : "") << std::endl;
+
+    // Different Hash size: either keep the snapshot's size or rehash into ours
+    const size_t oldMb = oldCount * sizeof(Cluster) >> 20;
+    free_table(oldTable, oldCount, oldMode);
+    if (policy == LoadPolicy::KEEP_SIZE && oldTable && oldCount != clusterCount)
+        rehash(oldMb, threadCount, false, topology);
+
+    return true;
 }
 
-void TranspositionTable::store(uint64_t key, Move move, int value, Bound bound, int depth) {
-    if (numEntries == 0) return;
+// Puts 'e' into 'c' if it is worth more than what it would displace. An
+// entry with the same key16 is a duplicate and only the better one stays.
+void TranspositionTable::keep_best(Cluster& c, const TTEntry& e) const {
+    const uint8_t gen = generation();
+    auto worth = [gen](const TTEntry& x) { return x.depth8 - x.relative_age(gen); };
 
-    bool found;
-    TTEntry* entry = probe(key, found);
-    if (!entry) return;
+    for (TTEntry& x : c.entries)
+        if (!x.empty() && x.key16 == e.key16) {
+            if (worth(e) > worth(x))
+                x = e;
+            return;
+        }
 
-    // Replacement scheme:
-    // 1. Always replace if empty or same key
-    // 2. Replace if depth is better
-    if (!found || entry->key16 != key16(key) || depth + 3 > entry->depth) {
-        entry->key16 = key16(key);
-        entry->move = move;
-        entry->value = static_cast<int16_t>(value);
-        entry->depth = static_cast<int8_t>(depth);
-        entry->bound = bound;
-        entry->generation = generation;
+    TTEntry* slot = &c.entries[0];
+    for (TTEntry& x : c.entries) {
+        if (x.empty()) {
+            slot = &x;
+            break;
+        }
+        if (worth(x) < worth(*slot))
+            slot = &x;
     }
-    // Always preserve best move if available
-    else if (move && (depth >= entry->depth || !entry->move)) {
-        entry->move = move;
+    if (slot->empty() || worth(e) > worth(*slot))
+        *slot = e;
+}
+
+bool TranspositionTable::probe(Key key, TTData& data, TTNode node) const {
+    if (clusterCount == 0)
+        return false;
+
+    if (statsEnabled)
+        bump(counters().probes[int(node)]);
+
+    const Cluster& c = cluster(key);
+    const uint16_t check = static_cast<uint16_t>(key);
+
+    // Seqlock read: an unchanged, even counter around the copy means no
+    // writer touched the cluster meanwhile. A few retries, then give up;
+    // a miss is always a safe answer.
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const uint16_t seq = c.sequence.load(std::memory_order_acquire);
+        if (seq & 1)
+            continue;
+
+        TTEntry copy[ClusterSize];
+        std::memcpy(copy, c.entries, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (c.sequence.load(std::memory_order_relaxed) != seq)
+            continue;
+
+        for (const TTEntry& e : copy)
+            if (e.key16 == check && !e.empty()) {
+                data = e.data();
+                if (statsEnabled)
+                    bump(counters().hits[int(node)]);
+                return true;
+            }
+        return false;
     }
+    return false;
+}
+
+void TranspositionTable::store(Key key, Move move, int value, int eval, Bound bound, int depth, bool pv) {
+    if (clusterCount == 0)
+        return;
+
+    Cluster& c = cluster(key);
+    uint16_t seq = c.sequence.load(std::memory_order_relaxed);
+    if ((seq & 1) || !c.sequence.compare_exchange_strong(seq, uint16_t(seq + 1),
+                                                         std::memory_order_acq_rel)) {
+        if (statsEnabled)
+            count_replacement(TTReplace::BUSY);
+        return;  // Another thread is writing this cluster
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Same position or an empty slot first, otherwise the entry worth least,
+    // where each generation of age counts as GENERATION_DELTA plies of depth
+    TTEntry* const tte = c.entries;
+    const uint8_t gen = generation();
+    const uint16_t check = static_cast<uint16_t>(key);
+    TTEntry* replace = nullptr;
+    for (int i = 0; i < ClusterSize && !replace; ++i)
+        if (tte[i].key16 == check || tte[i].empty())
+            replace = &tte[i];
+
+    TTReplace reason = replace && replace->empty() ? TTReplace::EMPTY : TTReplace::SAME_KEY;
+    if (!replace) {
+        replace = tte;
+        for (int i = 1; i < ClusterSize; ++i)
+            if (replace->depth8 - replace->relative_age(gen)
+                > tte[i].depth8 - tte[i].relative_age(gen))
+                replace = &tte[i];
+        reason = replace->relative_age(gen) ? TTReplace::AGED : TTReplace::DEPTH;
+    }
+
+    const bool written = replace->save(key, value, pv, bound, depth, move, eval, gen);
+    c.sequence.store(uint16_t(seq + 2), std::memory_order_release);
+
+    if (statsEnabled)
+        count_replacement(written ? reason : TTReplace::SAME_KEY_KEPT);
 }
 
 int TranspositionTable::hashfull() const {
-    const int samples = 1000;
+    const int samples = std::min<size_t>(1000, clusterCount);
+    const uint8_t gen = generation();
     int used = 0;
 
-    for (int i = 0; i < samples; ++i) {
-        const Cluster& cluster = table[(i * 2654435761U) % numEntries];
-        for (int j = 0; j < 3; ++j) {
-            if (cluster.entries[j].generation == generation) {
-                used++;
-                break;
+    for (int i = 0; i < samples; ++i)
+        for (int j = 0; j < ClusterSize; ++j)
+            used += !table[i].entries[j].empty()
+                 && (table[i].entries[j].genBound8 & GENERATION_MASK) == gen;
+
+    return samples ? used * 1000 / (samples * ClusterSize) : 0;
+}
+
+TranspositionTable::Counters& TranspositionTable::counters() const {
+    // Cache per thread; the instance id keeps a table that reuses a freed
+    // one's address from picking up its dangling block
+    thread_local uint64_t cachedOwner = 0;
+    thread_local Counters* cached = nullptr;
+    if (cachedOwner == instanceId)
+        return *cached;
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    const std::thread::id me = std::this_thread::get_id();
+    auto it = std::find_if(statsBlocks.begin(), statsBlocks.end(),
+                           [me](const std::unique_ptr<Counters>& b) { return b->owner == me; });
+    if (it == statsBlocks.end()) {
+        statsBlocks.push_back(std::make_unique<Counters>());
+        statsBlocks.back()->owner = me;
+        it = statsBlocks.end() - 1;
+    }
+    cachedOwner = instanceId;
+    cached = it->get();
+    return *cached;
+}
+
+void TranspositionTable::count_replacement(TTReplace reason) const {
+    bump(counters().replacements[int(reason)]);
+}
+
+void TranspositionTable::count_cutoff(TTNode node) {
+    if (statsEnabled)
+        bump(counters().cutoffs[int(node)]);
+}
+
+// Blocks stay registered (threads keep pointers to them); only zeroed.
+// Counts made by other threads while this runs may survive it.
+void TranspositionTable::reset_stats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (const std::unique_ptr<Counters>& b : statsBlocks) {
+        for (int n = 0; n < TT_NODE_NB; ++n) {
+            b->probes[n] = 0;
+            b->hits[n] = 0;
+            b->cutoffs[n] = 0;
+        }
+        for (std::atomic<uint64_t>& r : b->replacements)
+            r = 0;
+    }
+}
+
+TTStats TranspositionTable::stats(size_t threadCount) const {
+    TTStats s;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        for (const std::unique_ptr<Counters>& b : statsBlocks) {
+            for (int n = 0; n < TT_NODE_NB; ++n) {
+                s.probes[n]  += b->probes[n].load(std::memory_order_relaxed);
+                s.hits[n]    += b->hits[n].load(std::memory_order_relaxed);
+                s.cutoffs[n] += b->cutoffs[n].load(std::memory_order_relaxed);
             }
+            for (int r = 0; r < TT_REPLACE_NB; ++r)
+                s.replacements[r] += b->replacements[r].load(std::memory_order_relaxed);
         }
     }
-    return (used * 100) / samples;
-}
\ No newline at end of file
+
+    // Racy against concurrent stores, which only blurs the histogram. A
+    // read-only scan places no pages, so its threads are not bound.
+    const uint8_t gen = generation();
+    std::mutex merge;
+    s.entries = clusterCount * ClusterSize;
+    for_each_slice(clusterCount, threadCount, nullptr, [&](size_t start, size_t end) {
+        TTStats local;
+        for (size_t i = start; i < end; ++i)
+            for (const TTEntry& e : table[i].entries) {
+                if (e.empty())
+                    continue;
+                ++local.used;
+                ++local.depth[std::min(e.depth() - DEPTH_UNSEARCHED, TTStats::DepthBuckets - 1)];
+                ++local.age[e.relative_age(gen) / GENERATION_DELTA];
+            }
+
+        std::lock_guard<std::mutex> lock(merge);
+        s.used += local.used;
+        for (int d = 0; d < TTStats::DepthBuckets; ++d)
+            s.depth[d] += local.depth[d];
+        for (int a = 0; a < TTStats::AgeBuckets; ++a)
+            s.age[a] += local.age[a];
+    });
+    return s;
+}
+
+void TranspositionTable::print_stats(std::ostream& os, size_t threadCount) const {
+    const TTStats s = stats(threadCount);
+    auto percent = [](uint64_t part, uint64_t whole) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << (whole ? 100.0 * part / whole : 0.0) << "%";
+        return ss.str();
+    };
+
+    for (int n = 0; n < TT_NODE_NB; ++n)
+        os << "info string tt " << NodeNames[n] << " probes " << s.probes[n]
+           << " hits " << s.hits[n] << " (" << percent(s.hits[n], s.probes[n]) << ")"
+           << " cutoffs " << s.cutoffs[n] << " (" << percent(s.cutoffs[n], s.hits[n]) << " of hits)\n";
+
+    os << "info string tt replacements";
+    for (int r = 0; r < TT_REPLACE_NB; ++r)
+        os << " " << ReplaceNames[r] << " " << s.replacements[r];
+    os << "\n";
+
+    os << "info string tt entries " << s.entries << " used " << s.used
+       << " (" << percent(s.used, s.entries) << ")\n";
+    os << "info string tt depth";
+    for (int d = 0; d < TTStats::DepthBuckets; ++d)
+        if (s.depth[d])
+            os << " " << d + DEPTH_UNSEARCHED << (d + 1 == TTStats::DepthBuckets ? "+" : "")
+               << ":" << s.depth[d];
+    os << "\n";
+    os << "info string tt age";
+    for (int a = 0; a < TTStats::AgeBuckets; ++a)
+        if (s.age[a])
+            os << " " << a << ":" << s.age[a];
+    os << std::endl;
+}
+
+std::string TranspositionTable::stats_json(size_t threadCount) const {
+    const TTStats s = stats(threadCount);
+    std::ostringstream os;
+    auto object = [&os](const char* name, const uint64_t* values, const char* const* keys, int n) {
+        os << "\"" << name << "\":{";
+        for (int i = 0; i < n; ++i)
+            os << (i ? "," : "") << "\"" << keys[i] << "\":" << values[i];
+        os << "}";
+    };
+    auto array = [&os](const char* name, const uint64_t* values, int n) {
+        os << "\"" << name << "\":[";
+        for (int i = 0; i < n; ++i)
+            os << (i ? "," : "") << values[i];
+        os << "]";
+    };
+
+    os << "{";
+    object("probes", s.probes, NodeNames, TT_NODE_NB);
+    os << ",";
+    object("hits", s.hits, NodeNames, TT_NODE_NB);
+    os << ",";
+    object("cutoffs", s.cutoffs, NodeNames, TT_NODE_NB);
+    os << ",";
+    object("replacements", s.replacements, ReplaceNames, TT_REPLACE_NB);
+    os << ",\"entries\":" << s.entries << ",\"used\":" << s.used
+       << ",\"depth_offset\":" << DEPTH_UNSEARCHED << ",";
+    array("depth", s.depth, TTStats::DepthBuckets);
+    os << ",";
+    array("age", s.age, TTStats::AgeBuckets);
+    os << "}";
+    return os.str();
+}
@@ -3,55 +3,280 @@
 
 #include "types.h"
 #include "move.h"
+#include "util/memory.h"
+#include "util/numa.h"
+#include "util/prefetch.h"
+#include <atomic>
 #include <cstdint>
+#include <iosfwd>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
+// Two bits, so EXACT is both bounds at once
 enum Bound : uint8_t {
     BOUND_NONE = 0,
-    BOUND_EXACT = 1,
+    BOUND_UPPER = 1,
     BOUND_LOWER = 2,
-    BOUND_UPPER = 4
+    BOUND_EXACT = BOUND_UPPER | BOUND_LOWER
+};
+
+// Depth is stored biased so that depth8 == 0 marks an empty slot; quiescence
+// depths down to DEPTH_ENTRY_OFFSET + 1 still fit.
+constexpr int DEPTH_ENTRY_OFFSET = -7;
+constexpr int DEPTH_UNSEARCHED   = DEPTH_ENTRY_OFFSET + 1;  // Entry only caches a static eval
+constexpr int VALUE_NONE = 32002;  // Static eval slot not filled (e.g. in check)
+
+// genBound8 layout: generation in the top 5 bits, then ttPv, then the bound
+constexpr unsigned GENERATION_BITS  = 3;
+constexpr int      GENERATION_DELTA = 1 << GENERATION_BITS;
+constexpr int      GENERATION_CYCLE = 255 + GENERATION_DELTA;  // Keeps the age difference non-negative
+constexpr int      GENERATION_MASK  = (0xFF << GENERATION_BITS) & 0xFF;
+
+// Copy of one entry, taken under the cluster's sequence counter so that all
+// fields come from the same write
+struct TTData {
+    Move  move;
+    int   value;
+    int   eval;
+    int   depth;
+    Bound bound;
+    bool  isPv;
+};
+
+// Which search a probe comes from, for the telemetry split
+enum class TTNode : uint8_t { PV, NON_PV, QSEARCH };
+constexpr int TT_NODE_NB = 3;
+
+// Where store() put an entry, or why it did not
+enum class TTReplace : uint8_t {
+    EMPTY,          // Took an empty slot
+    SAME_KEY,       // Overwrote the entry of the same position
+    SAME_KEY_KEPT,  // Same position, but the stored entry was worth more
+    AGED,           // Evicted an entry from an earlier search
+    DEPTH,          // Evicted the least valuable entry of this search
+    BUSY            // Another writer held the cluster, store dropped
+};
+constexpr int TT_REPLACE_NB = 6;
+
+// Telemetry totals (see TranspositionTable::stats). The entry histograms
+// are a scan of the whole table, not a sample.
+struct TTStats {
+    static constexpr int DepthBuckets = 64;  // Depth DEPTH_UNSEARCHED and up, last one open-ended
+    static constexpr int AgeBuckets   = 256 / GENERATION_DELTA;
+
+    uint64_t probes[TT_NODE_NB]          = {};
+    uint64_t hits[TT_NODE_NB]            = {};
+    uint64_t cutoffs[TT_NODE_NB]         = {};  // Hits that ended the node, as reported by the search
+    uint64_t replacements[TT_REPLACE_NB] = {};
+
+    uint64_t entries = 0;                 // Slots in the table
+    uint64_t used    = 0;                 // Non-empty slots, any generation
+    uint64_t depth[DepthBuckets] = {};    // Used slots by depth - DEPTH_UNSEARCHED
+    uint64_t age[AgeBuckets]     = {};    // Used slots by searches since written
 };
 
 struct TTEntry {
-    uint16_t key16;     // Part of Zobrist key for validation
-    Move move;          // Best move
-    int16_t value;      // Evaluation value
-    int8_t depth;       // Search depth
-    uint8_t bound;      // Bound type
-    uint8_t generation; // Age counter
+    Move  move()  const { return move16; }
+    int   value() const { return value16; }
+    int   eval()  const { return eval16; }
+    int   depth() const { return int(depth8) + DEPTH_ENTRY_OFFSET; }
+    bool  is_pv() const { return genBound8 & 0x4; }
+    Bound bound() const { return Bound(genBound8 & 0x3); }
+    bool  empty() const { return depth8 == 0; }
+    TTData data() const { return { move(), value(), eval(), depth(), bound(), is_pv() }; }
+
+    // Only writes when the new data is worth more than what is kept; a move
+    // is kept across an overwrite of the same position that has none.
+    // Returns whether the data was written.
+    bool save(Key k, int v, bool pv, Bound b, int d, Move m, int ev, uint8_t generation8);
+
+    // Generations since this entry was written, in GENERATION_DELTA units
+    uint8_t relative_age(uint8_t generation8) const {
+        return (GENERATION_CYCLE + generation8 - genBound8) & GENERATION_MASK;
+    }
+
+private:
+    friend class TranspositionTable;
+
+    uint16_t key16;      // Low 16 bits of the Zobrist key; the index uses the high bits
+    Move     move16;     // Best or refutation move
+    int16_t  value16;    // Search value
+    int16_t  eval16;     // Static evaluation, VALUE_NONE if not computed
+    uint8_t  depth8;     // Depth - DEPTH_ENTRY_OFFSET, 0 when empty
+    uint8_t  genBound8;  // Generation(5) | ttPv(1) | bound(2)
 };
+static_assert(sizeof(TTEntry) == 10, "TTEntry must stay 10 bytes with a 16-bit Move");
 
 class TranspositionTable {
 public:
+    static constexpr int ClusterSize = 3;
+
     TranspositionTable();
     ~TranspositionTable();
 
-    void resize(size_t mbSize);
-    void clear();
-    void newGeneration();
+    // Allocates 2 MB aligned with the best page backing available (see
+    // Memory::alloc_large) and clears it with 'threadCount' threads.
+    void resize(size_t mbSize, size_t threadCount = 1, bool tryHugeTlb = false,
+                const Numa::Topology& topology = Numa::Topology::system());
+    // Each thread zeroes one slice while bound to the node 'topology' gives
+    // the search worker with the same index, so first touch puts the pages
+    // on that worker's NUMA node. Pass the ThreadPool's size and
+    // numa_topology().
+    void clear(size_t threadCount = 1, const Numa::Topology& topology = Numa::Topology::system());
+    // Like resize(), but the entries of the current table are moved into the
+    // new one (in parallel, same slicing as clear) instead of being dropped.
+    // Both tables are alive while it runs. On allocation failure the old
+    // table is kept.
+    void rehash(size_t mbSize, size_t threadCount = 1, bool tryHugeTlb = false,
+                const Numa::Topology& topology = Numa::Topology::system());
+    Memory::PageMode page_mode() const { return pageMode; }
+
+    // Snapshot file: a header (format version, Zobrist key fingerprint,
+    // generation, cluster count, checksum of the clusters) padded to
+    // SnapshotHeaderSize, then the raw cluster array. Call between searches.
+    static constexpr size_t SnapshotHeaderSize = 64 * 1024;  // Page aligned on all common page sizes
+    bool save(const std::string& path, size_t threadCount = 1,
+              const Numa::Topology& topology = Numa::Topology::system()) const;
+
+    // What load() does when the snapshot was written with another Hash size
+    enum class LoadPolicy {
+        ADOPT_SIZE,  // Use the file's size: it is mapped copy-on-write as the table, no copy
+        KEEP_SIZE    // Keep the current size: entries are rehashed in (as rehash())
+    };
+    // On a format or key mismatch, a bad checksum or I/O failure the current
+    // table is left untouched and false is returned. 'verify' reads the whole
+    // file once (in parallel) to check the checksum; without it the mapped
+    // table is usable at once and pages are read as the search touches them.
+    bool load(const std::string& path, LoadPolicy policy = LoadPolicy::ADOPT_SIZE,
+              size_t threadCount = 1, bool verify = true,
+              const Numa::Topology& topology = Numa::Topology::system());
+
+    // Cross-process table: maps the POSIX shared-memory segment 'name',
+    // creating it with 'mbSize' MB if it does not exist and otherwise
+    // attaching at the size it was created with, so cooperating engine
+    // processes search with one table. The seqlocked clusters work across
+    // processes unchanged. The generation lives in the segment as an epoch
+    // that every process ages entries by: newGeneration() advances it at
+    // most once per SharedEpochMs, whichever process gets there first, so
+    // one process starting a search neither ages the others' fresh entries
+    // nor wraps the generation. clear() wipes the table for everyone.
+    // Each process registers its pid in the segment; the last one to detach
+    // (detach_shared, resize, rehash, load or destruction) removes it, and
+    // pids of processes that died without detaching are pruned on the way.
+    bool attach_shared(const std::string& name, size_t mbSize);
+    void detach_shared();
+    bool is_shared() const { return pageMode == Memory::PageMode::SHARED; }
+    // Removes the segment 'name' left behind by processes that all died.
+    // Returns false if it does not exist or a live process is attached.
+    static bool remove_stale_shared(const std::string& name);
+    static constexpr size_t SegmentHeaderSize = SnapshotHeaderSize;
+    static constexpr uint64_t SharedEpochMs = 5000;
+
+    void newGeneration() {
+        if (sharedGeneration)
+            advance_shared_epoch();
+        else
+            generation8 += GENERATION_DELTA;
+    }
+    uint8_t generation() const {
+        return sharedGeneration ? sharedGeneration->load(std::memory_order_relaxed) : generation8;
+    }
+
+    // Lock-free and torn-read safe: readers copy the cluster between two loads
+    // of its sequence counter and retry (or report a miss) if a writer was
+    // inside. Probing never writes, so hits do not dirty shared cache lines.
+    // 'node' only matters to the telemetry.
+    bool probe(Key key, TTData& data, TTNode node = TTNode::NON_PV) const;
 
-    TTEntry* probe(uint64_t key, bool& found) const;
-    void store(uint64_t key, Move move, int value, Bound bound, int depth);
+    // Writers claim the cluster by making its counter odd with one CAS. If
+    // another thread holds it the store is dropped rather than waited for.
+    void store(Key key, Move move, int value, int eval, Bound bound, int depth, bool pv);
 
-    size_t size() const { return numEntries; }
-    int hashfull() const;
+    // Starts loading the cluster of 'key' (one cache line, clusters are 32
+    // byte aligned) for a probe or store a little later. It also holds the
+    // position's cached static eval.
+    void prefetch(Key key) const {
+        ChessEngine::prefetch<ChessEngine::PrefetchType::TT_READ>(&cluster(key));
+    }
+
+    size_t size() const { return clusterCount * ClusterSize; }
+    int hashfull() const;  // Permille of sampled entries from this search
+
+    // Opt-in telemetry. While enabled, every thread counts probes, hits and
+    // replacements into its own block (single writer, no locked
+    // instructions); while disabled probe and store pay one predictable
+    // branch. stats() sums the blocks and scans the table with 'threadCount'
+    // threads for the entry histograms.
+    void enable_stats(bool on) { statsEnabled = on; }
+    bool stats_enabled() const { return statsEnabled; }
+    void count_cutoff(TTNode node);  // The search cut off on a probe hit
+    void reset_stats();
+    TTStats stats(size_t threadCount = 1) const;
+    // "info string tt ..." lines for the debug command, and the same as JSON
+    void print_stats(std::ostream& os, size_t threadCount = 1) const;
+    std::string stats_json(size_t threadCount = 1) const;
 
 private:
     struct Cluster {
-        TTEntry entries[3]; // Three entries per cluster
-        uint8_t padding[2]; // Pad to 32 bytes
+        TTEntry entries[ClusterSize];
+        std::atomic<uint16_t> sequence;  // Odd while a writer is inside; fills the pad to 32 bytes
     };
     static_assert(sizeof(Cluster) == 32, "Incorrect cluster size");
+    static_assert(std::atomic<uint16_t>::is_always_lock_free, "Cluster sequence must be lock-free");
+
+    // The high 64 bits of key * clusterCount map the key onto
+    // [0, clusterCount) without a divide, for any size.
+    Cluster& cluster(Key key) const { return table[mul_hi64(key, clusterCount)]; }
+    // One thread's telemetry, written only by that thread
+    struct Counters {
+        std::thread::id owner;
+        std::atomic<uint64_t> probes[TT_NODE_NB]{};
+        std::atomic<uint64_t> hits[TT_NODE_NB]{};
+        std::atomic<uint64_t> cutoffs[TT_NODE_NB]{};
+        std::atomic<uint64_t> replacements[TT_REPLACE_NB]{};
+    };
+    Counters& counters() const;  // The calling thread's block, created on first use
+    void count_replacement(TTReplace reason) const;
+
+    void keep_best(Cluster& c, const TTEntry& e) const;
+    uint64_t checksum(size_t threadCount, const Numa::Topology& topology) const;
+    // Frees a table this object allocated, mapped or attached to
+    void free_table(Cluster* t, size_t count, Memory::PageMode mode);
+
+    static uint64_t mul_hi64(uint64_t a, uint64_t b) {
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+        __extension__ using uint128 = unsigned __int128;
+        return uint64_t(uint128(a) * b >> 64);
+#else
+        const uint64_t aL = uint32_t(a), aH = a >> 32;
+        const uint64_t bL = uint32_t(b), bH = b >> 32;
+        const uint64_t c1 = (aL * bL) >> 32;
+        const uint64_t c2 = aH * bL + c1;
+        const uint64_t c3 = aL * bH + uint32_t(c2);
+        return aH * bH + (c2 >> 32) + (c3 >> 32);
+#endif
+    }
 
     Cluster* table;
-    size_t numEntries;
-    uint8_t generation;
+    size_t clusterCount;
+    Memory::PageMode pageMode;
+    uint8_t generation8;  // Steps by GENERATION_DELTA, low bits stay zero
+
+    struct SharedSegment;
+    SharedSegment* segment;                   // Header of the attached segment, if shared
+    std::atomic<uint8_t>* sharedGeneration;   // Its generation, used instead of generation8
+    std::string segmentName;
+    void advance_shared_epoch();
 
-    size_t index(uint64_t key) const { return (key >> 32) % numEntries; }
-    uint16_t key16(uint64_t key) const { return static_cast<uint16_t>(key >> 16); }
+    bool statsEnabled;
+    const uint64_t instanceId;  // Tells this table's counters apart in the thread-local cache
+    mutable std::mutex statsMutex;
+    mutable std::vector<std::unique_ptr<Counters>> statsBlocks;
 };
 
 extern TranspositionTable TT;
 
-#endif // TT_H
\ No newline at end of file
+#endif // TT_H
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+
+// Core engine types shared by board, move generation, search and evaluation.
+
+using Bitboard = uint64_t;
+using Key      = uint64_t;
+
+constexpr int MAX_MOVES = 256;  // Upper bound on moves in any position
+constexpr int MAX_PLY   = 64;   // Maximum search ply
+
+enum Color : uint8_t { WHITE, BLACK, COLOR_NB = 2, COLOR_NONE = COLOR_NB };
+
+enum PieceType : uint8_t {
+    NONE, PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING,
+    PIECE_TYPE_NB,
+    ALL_PIECES = NONE
+};
+
+// Piece = (color << 3) | type, so counter-move style tables are [16][64]
+enum Piece : uint8_t {
+    NO_PIECE,
+    W_PAWN = 1, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    B_PAWN = 9, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
+    PIECE_NB = 16
+};
+
+enum Square : int {
+    SQ_A1, SQ_B1, SQ_C1, SQ_D1, SQ_E1, SQ_F1, SQ_G1, SQ_H1,
+    SQ_A2, SQ_B2, SQ_C2, SQ_D2, SQ_E2, SQ_F2, SQ_G2, SQ_H2,
+    SQ_A3, SQ_B3, SQ_C3, SQ_D3, SQ_E3, SQ_F3, SQ_G3, SQ_H3,
+    SQ_A4, SQ_B4, SQ_C4, SQ_D4, SQ_E4, SQ_F4, SQ_G4, SQ_H4,
+    SQ_A5, SQ_B5, SQ_C5, SQ_D5, SQ_E5, SQ_F5, SQ_G5, SQ_H5,
+    SQ_A6, SQ_B6, SQ_C6, SQ_D6, SQ_E6, SQ_F6, SQ_G6, SQ_H6,
+    SQ_A7, SQ_B7, SQ_C7, SQ_D7, SQ_E7, SQ_F7, SQ_G7, SQ_H7,
+    SQ_A8, SQ_B8, SQ_C8, SQ_D8, SQ_E8, SQ_F8, SQ_G8, SQ_H8,
+    SQ_NONE,
+    SQUARE_NB = 64
+};
+
+enum File : int { FILE_A, FILE_B, FILE_C, FILE_D, FILE_E, FILE_F, FILE_G, FILE_H, FILE_NB };
+enum Rank : int { RANK_1, RANK_2, RANK_3, RANK_4, RANK_5, RANK_6, RANK_7, RANK_8, RANK_NB };
+
+enum Direction : int {
+    NORTH = 8,
+    EAST  = 1,
+    SOUTH = -NORTH,
+    WEST  = -EAST,
+
+    NORTH_EAST = NORTH + EAST,
+    SOUTH_EAST = SOUTH + EAST,
+    SOUTH_WEST = SOUTH + WEST,
+    NORTH_WEST = NORTH + WEST
+};
+
+// Increment operators so enums can drive plain for-loops
+#define ENABLE_INCR_OPERATORS_ON(T)                                     \
+    constexpr T& operator++(T& d) { return d = T(int(d) + 1); }         \
+    constexpr T& operator--(T& d) { return d = T(int(d) - 1); }         \
+    constexpr T operator++(T& d, int) { T old = d; ++d; return old; }
+
+ENABLE_INCR_OPERATORS_ON(Color)
+ENABLE_INCR_OPERATORS_ON(PieceType)
+ENABLE_INCR_OPERATORS_ON(Square)
+ENABLE_INCR_OPERATORS_ON(File)
+ENABLE_INCR_OPERATORS_ON(Rank)
+
+#undef ENABLE_INCR_OPERATORS_ON
+
+constexpr Square operator+(Square s, Direction d) { return Square(int(s) + int(d)); }
+constexpr Square operator-(Square s, Direction d) { return Square(int(s) - int(d)); }
+inline Square& operator+=(Square& s, Direction d) { return s = s + d; }
+inline Square& operator-=(Square& s, Direction d) { return s = s - d; }
+
+constexpr Color operator~(Color c) { return Color(c ^ BLACK); }
+
+constexpr bool is_ok(Square s) { return s >= SQ_A1 && s <= SQ_H8; }
+
+constexpr Square make_square(File f, Rank r) { return Square((r << 3) + f); }
+constexpr File file_of(Square s) { return File(s & 7); }
+constexpr Rank rank_of(Square s) { return Rank(s >> 3); }
+
+constexpr Square relative_square(Color c, Square s) { return Square(s ^ (c * 56)); }
+constexpr Rank relative_rank(Color c, Rank r) { return Rank(r ^ (c * 7)); }
+constexpr Rank relative_rank(Color c, Square s) { return relative_rank(c, rank_of(s)); }
+
+constexpr Direction pawn_push(Color c) { return c == WHITE ? NORTH : SOUTH; }
+
+constexpr Piece make_piece(Color c, PieceType pt) { return Piece((c << 3) + pt); }
+constexpr PieceType type_of(Piece pc) { return PieceType(pc & 7); }
+constexpr Color color_of(Piece pc) { return Color(pc >> 3); }
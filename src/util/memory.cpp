@@ -0,0 +1,157 @@
+#include "memory.h"
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_POSIX_SHM 1
+#endif
+
+namespace Memory {
+
+namespace {
+
+size_t round_up(size_t size) {
+    return (size + LargePageSize - 1) / LargePageSize * LargePageSize;
+}
+
+} // namespace
+
+const char* page_mode_name(PageMode mode) {
+    switch (mode) {
+        case PageMode::HUGETLB:     return "hugetlb";
+        case PageMode::TRANSPARENT: return "transparent huge";
+        case PageMode::FILE_MAPPED: return "file mapped";
+        case PageMode::SHARED:      return "shared";
+        default:                    return "normal";
+    }
+}
+
+void* alloc_large(size_t size, bool tryHugeTlb, PageMode& mode) {
+    size = round_up(size);
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (tryHugeTlb) {
+        void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            mode = PageMode::HUGETLB;
+            return mem;
+        }
+    }
+#else
+    (void)tryHugeTlb;
+#endif
+
+    void* mem = std::aligned_alloc(LargePageSize, size);
+    if (!mem)
+        return nullptr;
+
+    mode = PageMode::NORMAL;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (madvise(mem, size, MADV_HUGEPAGE) == 0)
+        mode = PageMode::TRANSPARENT;
+#endif
+    return mem;
+}
+
+void* map_file(const char* path, size_t offset, size_t size) {
+#if defined(__linux__)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, off_t(offset));
+    close(fd);  // The mapping keeps the file referenced
+    return mem == MAP_FAILED ? nullptr : mem;
+#else
+    (void)path;
+    (void)offset;
+    (void)size;
+    return nullptr;
+#endif
+}
+
+void* open_shared(const char* name, size_t& size, bool& created) {
+#ifdef HAS_POSIX_SHM
+    int fd = size ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) : -1;
+    created = fd >= 0;
+    if (created) {
+        if (ftruncate(fd, off_t(size)) != 0) {
+            close(fd);
+            shm_unlink(name);
+            return nullptr;
+        }
+    } else {
+        if ((size && errno != EEXIST) || (fd = shm_open(name, O_RDWR, 0600)) < 0)
+            return nullptr;
+
+        // The creator sizes the segment right after creating it; give it a second
+        struct stat st;
+        for (int i = 0; fstat(fd, &st) == 0 && st.st_size == 0 && i < 1000; ++i)
+            usleep(1000);
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return nullptr;
+        }
+        size = size_t(st.st_size);
+    }
+
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        if (created)
+            shm_unlink(name);
+        return nullptr;
+    }
+    return mem;
+#else
+    (void)name;
+    (void)size;
+    created = false;
+    return nullptr;
+#endif
+}
+
+void close_shared(void* mem, size_t size) {
+#ifdef HAS_POSIX_SHM
+    if (mem)
+        munmap(mem, size);
+#else
+    (void)mem;
+    (void)size;
+#endif
+}
+
+bool unlink_shared(const char* name) {
+#ifdef HAS_POSIX_SHM
+    return shm_unlink(name) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void free_large(void* mem, size_t size, PageMode mode) {
+    if (!mem)
+        return;
+#if defined(__linux__)
+    if (mode == PageMode::HUGETLB || mode == PageMode::FILE_MAPPED) {
+        munmap(mem, mode == PageMode::HUGETLB ? round_up(size) : size);
+        return;
+    }
+#else
+    (void)size;
+    (void)mode;
+#endif
+    std::free(mem);
+}
+
+} // namespace Memory
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+
+namespace Memory {
+
+// How a large block is backed: allocation modes best first, then file maps
+enum class PageMode {
+    HUGETLB,      // Explicit huge pages (MAP_HUGETLB), needs reserved pages
+    TRANSPARENT,  // 2 MB aligned with madvise(MADV_HUGEPAGE); the kernel may still split it
+    NORMAL,       // Plain pages
+    FILE_MAPPED,  // Private copy-on-write mapping of a file (see map_file)
+    SHARED        // Named shared-memory segment (see open_shared)
+};
+
+const char* page_mode_name(PageMode mode);
+
+constexpr size_t LargePageSize = size_t(2) << 20;
+
+// Allocates at least 'size' bytes, 2 MB aligned, with the best page backing
+// the system grants. Explicit huge pages are only tried when 'tryHugeTlb'
+// is set; every failure falls back to the next mode. The memory is not
+// zeroed, so the first write decides which NUMA node a page lands on.
+// Returns nullptr if even plain pages are unavailable.
+void* alloc_large(size_t size, bool tryHugeTlb, PageMode& mode);
+
+// Maps 'size' bytes of 'path' starting at 'offset' (a multiple of the page
+// size) copy-on-write: pages are read from disk on first touch and writes
+// stay private to the process. Returns nullptr where mmap is unavailable.
+void* map_file(const char* path, size_t offset, size_t size);
+
+// Named POSIX shared memory (shm_open + mmap, MAP_SHARED). Creates the
+// segment with 'size' zeroed bytes if 'name' does not exist yet, otherwise
+// maps the existing one and stores its size in 'size'. 'created' tells
+// which happened. With 'size' 0 only an existing segment is opened.
+// Returns nullptr on failure or where POSIX shm is missing.
+void* open_shared(const char* name, size_t& size, bool& created);
+void close_shared(void* mem, size_t size);
+bool unlink_shared(const char* name);
+
+// 'size' and 'mode' must be the ones alloc_large/map_file was called with
+// or returned. SHARED mappings are released with close_shared instead.
+void free_large(void* mem, size_t size, PageMode mode);
+
+} // namespace Memory
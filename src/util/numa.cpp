@@ -0,0 +1,186 @@
+#include "numa.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Numa {
+
+namespace {
+
+// Node directories are "node<N>"; returns N, or -1 for anything else
+int node_number(const char* name) {
+    if (std::string(name).compare(0, 4, "node") != 0 || !name[4])
+        return -1;
+    int n = 0;
+    for (const char* p = name + 4; *p; ++p) {
+        if (!std::isdigit(static_cast<unsigned char>(*p)))
+            return -1;
+        n = n * 10 + (*p - '0');
+    }
+    return n;
+}
+
+} // namespace
+
+bool parse_cpulist(const std::string& list, std::vector<int>& cpus) {
+    std::vector<int> result;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(),
+                                   [](unsigned char c) { return std::isspace(c); }),
+                    range.end());
+        if (range.empty())
+            continue;
+
+        int first, last;
+        char dash;
+        std::istringstream r(range);
+        if (!(r >> first) || first < 0)
+            return false;
+        last = first;
+        if (r >> dash && (dash != '-' || !(r >> last) || last < first))
+            return false;
+        if (!r.eof() && r.peek() != EOF)
+            return false;
+        for (int cpu = first; cpu <= last; ++cpu)
+            result.push_back(cpu);
+    }
+    cpus = std::move(result);
+    return true;
+}
+
+Topology::Topology() {
+    const int count = int(std::max(1u, std::thread::hardware_concurrency()));
+    nodeCpus.emplace_back();
+    for (int cpu = 0; cpu < count; ++cpu)
+        nodeCpus[0].push_back(cpu);
+    cpuCount = size_t(count);
+}
+
+Topology Topology::detect(const std::string& root) {
+    Topology topo;
+
+#ifdef __linux__
+    DIR* dir = opendir(root.c_str());
+    if (!dir)
+        return topo;
+
+    std::vector<std::pair<int, std::vector<int>>> found;
+    while (const dirent* entry = readdir(dir)) {
+        const int node = node_number(entry->d_name);
+        if (node < 0)
+            continue;
+        std::ifstream in(root + "/" + entry->d_name + "/cpulist");
+        std::string list;
+        std::vector<int> cpus;
+        if (in && std::getline(in, list) && parse_cpulist(list, cpus))
+            found.emplace_back(node, std::move(cpus));
+    }
+    closedir(dir);
+    std::sort(found.begin(), found.end());
+
+    // Only CPUs this process may run on (taskset, cgroups)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    Topology detected;
+    detected.nodeCpus.clear();
+    detected.cpuCount = 0;
+    for (auto& node : found) {
+        std::vector<int> cpus;
+        for (int cpu : node.second)
+            if (!haveMask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)))
+                cpus.push_back(cpu);
+        if (cpus.empty())
+            continue;
+        detected.cpuCount += cpus.size();
+        detected.nodeCpus.push_back(std::move(cpus));
+    }
+    if (detected.cpuCount)
+        topo = std::move(detected);
+#else
+    (void)root;
+#endif
+    return topo;
+}
+
+bool Topology::parse(const std::string& desc, Topology& topo) {
+    Topology parsed;
+    parsed.nodeCpus.clear();
+    parsed.cpuCount = 0;
+
+    std::istringstream in(desc);
+    std::string list;
+    while (std::getline(in, list, ':')) {
+        std::vector<int> cpus;
+        if (!parse_cpulist(list, cpus) || cpus.empty())
+            return false;
+        parsed.cpuCount += cpus.size();
+        parsed.nodeCpus.push_back(std::move(cpus));
+    }
+    if (!parsed.cpuCount)
+        return false;
+    topo = std::move(parsed);
+    return true;
+}
+
+const Topology& Topology::system() {
+    static const Topology topo = detect();
+    return topo;
+}
+
+size_t Topology::node_of(size_t idx, size_t threadCount) const {
+    // Thread idx takes the CPU at the same relative position in the
+    // concatenated CPU lists
+    size_t pos = idx % threadCount * cpuCount / threadCount;
+    size_t node = 0;
+    while (pos >= nodeCpus[node].size())
+        pos -= nodeCpus[node++].size();
+    return node;
+}
+
+bool Topology::bind_current_thread(size_t node) const {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : nodeCpus[node])
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+std::string Topology::to_string() const {
+    std::string s;
+    for (size_t node = 0; node < nodeCpus.size(); ++node) {
+        if (node)
+            s += ':';
+        const std::vector<int>& cpus = nodeCpus[node];
+        for (size_t i = 0; i < cpus.size(); ) {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+                ++j;
+            if (i)
+                s += ',';
+            s += std::to_string(cpus[i]);
+            if (j > i)
+                s += '-' + std::to_string(cpus[j]);
+            i = j + 1;
+        }
+    }
+    return s;
+}
+
+} // namespace Numa
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Numa {
+
+// The machine's NUMA nodes and the CPUs of each. Search threads are spread
+// over the nodes in contiguous, balanced groups and bound to all CPUs of
+// their node, so whatever they allocate after binding is node-local.
+class Topology {
+public:
+    // One node with CPUs 0 .. hardware_concurrency - 1
+    Topology();
+
+    // Reads <root>/node*/cpulist, dropping CPUs outside this process's
+    // affinity mask and nodes left without CPUs (memory-only nodes). Falls
+    // back to a single node where the directory is missing.
+    static Topology detect(const std::string& root = "/sys/devices/system/node");
+
+    // Synthetic topology for tests and the "NUMA Topology" option: one
+    // cpulist per node, separated by ':', e.g. "0-3,8-11:4-7,12-15".
+    // Returns false, leaving 'topo' alone, on a malformed description.
+    static bool parse(const std::string& desc, Topology& topo);
+
+    // detect() on first use, then cached
+    static const Topology& system();
+
+    size_t nodes() const { return nodeCpus.size(); }
+    size_t cpus() const { return cpuCount; }
+    const std::vector<int>& cpus_of(size_t node) const { return nodeCpus[node]; }
+
+    // Node of thread 'idx' out of 'threadCount': threads go to nodes in
+    // proportion to their CPU counts, in order, so thread 0 (the main one)
+    // is on node 0 and consecutive threads share a node
+    size_t node_of(size_t idx, size_t threadCount) const;
+
+    // Binds the calling thread to every CPU of 'node'. Fails harmlessly,
+    // returning false, when the CPUs do not exist (synthetic topologies)
+    // or affinity is unsupported.
+    bool bind_current_thread(size_t node) const;
+
+    std::string to_string() const;  // In parse() syntax
+
+private:
+    std::vector<std::vector<int>> nodeCpus;
+    size_t cpuCount = 0;
+};
+
+// Parses a kernel cpulist ("0-3,8,10-11"); false if malformed
+bool parse_cpulist(const std::string& list, std::vector<int>& cpus);
+
+} // namespace Numa
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <cstddef>
-#include <immintrin.h>  // For AVX/SSE intrinsics
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace ChessEngine {
 
-// Prefetch hints tuned for chess engine patterns
+// What is being fetched; picks the read/write intent and the cache level
 enum class PrefetchType {
     TT_READ,       // Transposition Table read (high locality)
     TT_WRITE,      // Transposition Table write
@@ -15,25 +17,23 @@ enum class PrefetchType {
     HISTORY        // History heuristic tables
 };
 
-// Main prefetch function (constexpr compatible)
+// Starts loading the cache line holding 'addr' and returns at once. Meant
+// for addresses computed ahead of use, e.g. the child node's TT cluster
+// before make_move, so the DRAM latency overlaps with the move's own work.
+// A no-op where the compiler has no prefetch intrinsic.
 template <PrefetchType P = PrefetchType::TT_READ>
 inline void prefetch(const void* addr) noexcept {
-    constexpr int hints[] = {
-        _MM_HINT_T0,   // TT_READ: Strong temporal locality
-        _MM_HINT_T1,   // TT_WRITE: Moderate temporal
-        _MM_HINT_T2,   // PAWN_READ: Light temporal
-        _MM_HINT_NTA,  // EVAL_CACHE: Non-temporal
-        _MM_HINT_T0,   // KILLER_MOVES
-        _MM_HINT_T0    // HISTORY
-    };
-    _mm_prefetch(static_cast<const char*>(addr), hints[static_cast<int>(P)]);
+    // Everything here is read by the next node or two: keep it in all
+    // levels, except the eval cache, which is looked at once per position
+    constexpr int Locality = P == PrefetchType::EVAL_CACHE ? 1 : 3;
+    constexpr int Write    = P == PrefetchType::TT_WRITE ? 1 : 0;
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, Write, Locality);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(addr), Locality == 3 ? _MM_HINT_T0 : _MM_HINT_T2);
+#else
+    (void)addr;
+#endif
 }
 
-// Aggressive multi-line prefetch for critical sections
-inline void prefetch_tt_cluster(const void* addr) noexcept {
-    const char* base = static_cast<const char*>(addr);
-    _mm_prefetch(base + 0 * 64, _MM_HINT_T0);  // Primary entry
-    _mm_prefetch(base + 1 * 64, _MM_HINT_T1);  // Secondary entry (for bucket TT)
-}
-
-} // namespace ChessEngine
\ No newline at end of file
+} // namespace ChessEngine
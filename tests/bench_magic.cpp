@@ -0,0 +1,97 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include "../src/magic.h"
+#include "../src/attack.h"
+
+using namespace std;
+using namespace chrono;
+
+// Random (square, occupancy) probes, reused for every backend
+struct Probe {
+    Square sq;
+    Bitboard occ;
+};
+
+vector<Probe> make_probes(size_t count) {
+    mt19937_64 rng(20250801);
+    vector<Probe> probes(count);
+    for (auto& p : probes) {
+        p.sq = Square(rng() & 63);
+        p.occ = rng() & rng();  // ~16 pieces on average, like a middlegame
+    }
+    return probes;
+}
+
+// Check every backend against the reference ray walk
+bool verify(const vector<Probe>& probes) {
+    for (const Probe& p : probes) {
+        const Bitboard b = Attack::sliding_attacks(BISHOP, p.sq, p.occ);
+        const Bitboard r = Attack::sliding_attacks(ROOK, p.sq, p.occ);
+        if (Magic::lookup<Magic::Backend::FANCY, BISHOP>(p.sq, p.occ) != b ||
+            Magic::lookup<Magic::Backend::FANCY, ROOK>(p.sq, p.occ) != r) {
+            cerr << "FANCY mismatch on square " << p.sq << "\n";
+            return false;
+        }
+#ifdef HAS_PEXT
+        if (Magic::lookup<Magic::Backend::PEXT, BISHOP>(p.sq, p.occ) != b ||
+            Magic::lookup<Magic::Backend::PEXT, ROOK>(p.sq, p.occ) != r) {
+            cerr << "PEXT mismatch on square " << p.sq << "\n";
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+template <typename Fn>
+void run(const char* name, const vector<Probe>& probes, int rounds, Fn lookup) {
+    Bitboard sink = 0;
+    auto start = high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const Probe& p : probes)
+            sink ^= lookup(p.sq, p.occ ^ sink);  // Dependency chain defeats hoisting
+    auto end = high_resolution_clock::now();
+
+    const double elapsed = duration_cast<duration<double>>(end - start).count();
+    const double lookups = 2.0 * rounds * probes.size();  // Rook + bishop per probe
+    cout << left << setw(10) << name << right << fixed << setprecision(1)
+         << setw(10) << lookups / elapsed / 1e6 << " M lookups/s"
+         << "  (sink " << (sink & 0xFF) << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? stoi(argv[1]) : 200;
+
+    Magic::init();
+    const vector<Probe> probes = make_probes(1 << 16);
+
+    if (!verify(probes))
+        return 1;
+
+    cout << "Selected backend: " << Magic::backend_name(Magic::backend())
+         << (Magic::cpu_has_fast_pext() ? " (fast PEXT detected)" : "") << "\n";
+
+    run("fancy", probes, rounds, [](Square s, Bitboard occ) {
+        return Magic::lookup<Magic::Backend::FANCY, ROOK>(s, occ)
+             | Magic::lookup<Magic::Backend::FANCY, BISHOP>(s, occ);
+    });
+#ifdef HAS_PEXT
+    run("pext", probes, rounds, [](Square s, Bitboard occ) {
+        return Magic::lookup<Magic::Backend::PEXT, ROOK>(s, occ)
+             | Magic::lookup<Magic::Backend::PEXT, BISHOP>(s, occ);
+    });
+#else
+    cout << "pext      not compiled in (build without BMI2)\n";
+#endif
+    run("dispatch", probes, rounds, [](Square s, Bitboard occ) {
+        return get_rook_attacks(s, occ) | get_bishop_attacks(s, occ);
+    });
+    run("rays", probes, max(1, rounds / 50), [](Square s, Bitboard occ) {
+        return Attack::sliding_attacks(ROOK, s, occ) | Attack::sliding_attacks(BISHOP, s, occ);
+    });
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include "../src/serialize.h"
+#include "../src/movegen.h"
+#include "../src/magic.h"
+
+using namespace std;
+using namespace chrono;
+
+// Random (origin, target set) pairs shaped like real attack sets
+struct Job {
+    Square from;
+    Bitboard targets;
+};
+
+vector<Job> make_jobs(size_t count) {
+    mt19937_64 rng(20250802);
+    vector<Job> jobs(count);
+    for (auto& j : jobs) {
+        j.from = Square(rng() & 63);
+        j.targets = rng() & rng() & rng();  // ~8 targets, like a piece's moves
+    }
+    return jobs;
+}
+
+template <Serialize::Backend B>
+bool same_as_scalar(const vector<Job>& jobs) {
+    Move ref[MAX_MOVES], out[MAX_MOVES];
+    for (const Job& j : jobs) {
+        Move* refEnd = Serialize::piece_moves<Serialize::Backend::SCALAR>(ref, j.from, j.targets);
+        Move* outEnd = Serialize::piece_moves<B>(out, j.from, j.targets);
+        if (outEnd - out != refEnd - ref || !equal(ref, refEnd, out))
+            return false;
+        refEnd = Serialize::pawn_moves<SOUTH, Serialize::Backend::SCALAR>(ref, j.targets & ~RANK_8_BB);
+        outEnd = Serialize::pawn_moves<SOUTH, B>(out, j.targets & ~RANK_8_BB);
+        if (outEnd - out != refEnd - ref || !equal(ref, refEnd, out))
+            return false;
+    }
+    return true;
+}
+
+template <Serialize::Backend B>
+void run(const vector<Job>& jobs, int rounds) {
+    Move buffer[MAX_MOVES];
+    size_t moves = 0;
+    unsigned sink = 0;
+    auto start = high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const Job& j : jobs) {
+            const Move* end = Serialize::piece_moves<B>(buffer, j.from, j.targets);
+            moves += size_t(end - buffer);
+            sink += buffer[0].raw();  // Keep the stores alive
+        }
+    auto end = high_resolution_clock::now();
+
+    const double elapsed = duration_cast<duration<double>>(end - start).count();
+    cout << left << setw(10) << Serialize::backend_name(B) << right << fixed << setprecision(1)
+         << setw(10) << moves / elapsed / 1e6 << " M moves/s"
+         << "  (sink " << (sink & 0xFF) << ")\n";
+}
+
+// Whole legal generation, serialized by the compiled-in backend
+void run_generate(int rounds) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    };
+    vector<Board> boards;
+    for (const char* fen : fens) {
+        boards.emplace_back();
+        boards.back().set_fen(fen);
+    }
+
+    size_t moves = 0;
+    auto start = high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const Board& b : boards) {
+            MoveList<> list;
+            generate<LEGAL>(b, list);
+            moves += list.size();
+        }
+    auto end = high_resolution_clock::now();
+
+    const double elapsed = duration_cast<duration<double>>(end - start).count();
+    cout << left << setw(10) << "generate" << right << fixed << setprecision(1)
+         << setw(10) << moves / elapsed / 1e6 << " M moves/s  (LEGAL, "
+         << Serialize::backend_name(Serialize::Best) << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? stoi(argv[1]) : 200;
+
+    Magic::init();
+    const vector<Job> jobs = make_jobs(1 << 16);
+
+#ifdef HAS_BMI
+    if (!same_as_scalar<Serialize::Backend::BMI>(jobs)) {
+        cerr << "BMI serialization mismatch\n";
+        return 1;
+    }
+#endif
+#ifdef HAS_VPCOMPRESS
+    if (!same_as_scalar<Serialize::Backend::AVX512>(jobs)) {
+        cerr << "AVX512 serialization mismatch\n";
+        return 1;
+    }
+#endif
+
+    run<Serialize::Backend::SCALAR>(jobs, rounds);
+#ifdef HAS_BMI
+    run<Serialize::Backend::BMI>(jobs, rounds);
+#else
+    cout << "bmi       not compiled in (build without BMI1)\n";
+#endif
+#ifdef HAS_VPCOMPRESS
+    run<Serialize::Backend::AVX512>(jobs, rounds);
+#else
+    cout << "avx512    not compiled in (build without AVX512-VBMI2)\n";
+#endif
+    run_generate(rounds * 2000);
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include "../src/tt.h"
+#include "../src/movegen.h"
+#include "../src/magic.h"
+
+using namespace std;
+using namespace chrono;
+
+// A search-shaped walk: every node probes the TT and stores its result, so
+// the run is dominated by cluster misses once the table outgrows the cache.
+// With Prefetch the child's cluster is requested before make_move, as the
+// search does.
+template <bool Prefetch>
+uint64_t walk(Board& b, int depth, TranspositionTable& tt) {
+    TTData d;
+    uint64_t nodes = 1 + tt.probe(b.key(), d);
+    if (depth == 0) {
+        tt.store(b.key(), Move::none(), 0, 0, BOUND_EXACT, 0, false);
+        return nodes;
+    }
+
+    MoveList<> list;
+    generate<LEGAL>(b, list);
+    for (Move m : list) {
+        if (Prefetch)
+            tt.prefetch(b.key_after(m));
+        StateInfo st;
+        b.make_move(m, st);
+        nodes += walk<Prefetch>(b, depth - 1, tt);
+        b.unmake_move();
+    }
+    tt.store(b.key(), list.size() ? list[0] : Move::none(), 0, 0, BOUND_EXACT, depth, false);
+    return nodes;
+}
+
+template <bool Prefetch>
+double run(TranspositionTable& tt, int depth) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    };
+
+    tt.clear();
+    uint64_t nodes = 0;
+    auto start = high_resolution_clock::now();
+    for (const char* fen : fens) {
+        Board b;
+        b.set_fen(fen);
+        nodes += walk<Prefetch>(b, depth, tt);
+    }
+    auto end = high_resolution_clock::now();
+    return nodes / duration_cast<duration<double>>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int depth = argc > 1 ? stoi(argv[1]) : 4;
+
+    Magic::init();
+    for (size_t mb : { 16, 256, 1024 }) {
+        TranspositionTable tt;
+        tt.resize(mb);
+        // Alternate and keep the best of three, the machine is shared
+        double plain = 0, fetched = 0;
+        for (int i = 0; i < 3; ++i) {
+            plain = max(plain, run<false>(tt, depth));
+            fetched = max(fetched, run<true>(tt, depth));
+        }
+        cout << setw(5) << mb << " MB  " << fixed << setprecision(2)
+             << setw(7) << plain / 1e6 << " -> " << setw(7) << fetched / 1e6 << " M nodes/s  ("
+             << showpos << setprecision(1) << (fetched / plain - 1) * 100 << noshowpos << "%)\n";
+    }
+    return 0;
+}
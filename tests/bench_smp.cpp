@@ -0,0 +1,65 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include "../src/thread.h"
+#include "../src/magic.h"
+
+using namespace std;
+using namespace chrono;
+
+// SMP time-to-depth: wall time for the main thread to complete a fixed
+// depth, summed over a few middlegame positions, with a cleared TT each
+// time. Lazy SMP and ABDADA side by side; the third argument caps the
+// thread count.
+int main(int argc, char* argv[]) {
+    const int depth = argc > 1 ? stoi(argv[1]) : 9;
+    const size_t hashMb = argc > 2 ? stoul(argv[2]) : 64;
+    const size_t maxThreads = argc > 3 ? stoul(argv[3]) : 16;
+
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 8",
+        "r2q1rk1/1b2bppp/p2p1n2/1p2p3/3NP3/1BN1B3/PPP2PPP/R2Q1RK1 w - - 0 12",
+        "2r2rk1/pp1bqppp/2n1pn2/3p4/3P4/2PBPN2/P1Q2PPP/R1B2RK1 w - - 0 14",
+    };
+
+    Magic::init();
+    TT.resize(hashMb);
+    cout << "Time to depth " << depth << " on " << thread::hardware_concurrency() << " hardware threads\n";
+
+    double base = 0;
+    for (SmpMode mode : { SmpMode::LAZY, SmpMode::ABDADA }) {
+        cout << smp_mode_name(mode) << ":\n";
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            Threads.set(threads);
+            Threads.set_mode(mode);
+            double elapsed = 0;
+            uint64_t nodes = 0;
+            for (const char* fen : fens) {
+                Board b;
+                b.set_fen(fen);
+                TT.clear(threads, Threads.numa_topology());
+                Threads.clear();
+
+                SearchLimits limits;
+                limits.depth = depth;
+                limits.printInfo = false;
+                auto start = steady_clock::now();
+                Threads.start_thinking(b, limits);
+                Threads.wait_for_search_finished();
+                elapsed += duration_cast<duration<double>>(steady_clock::now() - start).count();
+                nodes += Threads.nodes_searched();
+            }
+            // Speedups are against single-threaded Lazy SMP (plain search)
+            if (!base)
+                base = elapsed;
+            cout << setw(3) << threads << " threads  " << fixed << setprecision(3) << setw(8) << elapsed
+                 << " s  speedup " << setprecision(2) << base / elapsed << "x  "
+                 << setw(12) << nodes << " nodes  " << setprecision(0) << nodes / elapsed / 1000
+                 << " knps\n";
+        }
+    }
+    Threads.set(0);
+    return 0;
+}
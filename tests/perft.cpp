@@ -6,6 +6,7 @@
 #include "../src/board.h"
 #include "../src/movegen.h"
 #include "../src/move.h"
+#include "../src/magic.h"
 
 using namespace std;
 using namespace chrono;
@@ -21,21 +22,26 @@ struct PerftStats {
     uint64_t checkmates = 0;
 };
 
-// Recursive perft with full move statistics
-void perft(Board& pos, int depth, PerftStats& stats, bool bulk_counting = true) {
+// Recursive perft with full move statistics. The board cannot tell whether
+// the last move captured, so the caller checks before making it.
+void perft(Board& pos, int depth, PerftStats& stats, bool bulk_counting = true, bool captured = false) {
     if (depth == 0) {
         stats.nodes++;
-        if (pos.last_move().is_capture()) stats.captures++;
+        if (captured) stats.captures++;
         if (pos.last_move().is_enpassant()) stats.enpassants++;
         if (pos.last_move().is_castle()) stats.castles++;
         if (pos.last_move().is_promotion()) stats.promotions++;
         if (pos.in_check()) stats.checks++;
-        if (pos.is_checkmate()) stats.checkmates++;
+        if (pos.in_check()) {
+            MoveList<> replies;
+            generate<LEGAL>(pos, replies);
+            if (replies.size() == 0) stats.checkmates++;
+        }
         return;
     }
 
-    vector<Move> moves;
-    generate_moves(pos, moves);
+    MoveList<> moves;
+    generate<LEGAL>(pos, moves);
 
     // Bulk counting optimization (3x faster at depth 6+)
     if (bulk_counting && depth == 1) {
@@ -44,27 +50,28 @@ void perft(Board& pos, int depth, PerftStats& stats, bool bulk_counting = true)
     }
 
     for (const Move& m : moves) {
-        if (!pos.is_legal(m)) continue;
-        pos.make_move(m);
-        perft(pos, depth - 1, stats, bulk_counting);
+        const bool capture = pos.is_capture(m);
+        StateInfo st;
+        pos.make_move(m, st);
+        perft(pos, depth - 1, stats, bulk_counting, capture);
         pos.unmake_move();
     }
 }
 
 // Detailed move breakdown with verification
 void perft_divide(Board& pos, int depth, bool verify) {
-    vector<Move> moves;
-    generate_moves(pos, moves);
+    MoveList<> moves;
+    generate<LEGAL>(pos, moves);
 
     PerftStats total;
     vector<pair<Move, PerftStats>> move_stats;
 
     for (const Move& m : moves) {
-        if (!pos.is_legal(m)) continue;
-        
         PerftStats current;
-        pos.make_move(m);
-        perft(pos, depth - 1, current);
+        const bool capture = pos.is_capture(m);
+        StateInfo st;
+        pos.make_move(m, st);
+        perft(pos, depth - 1, current, true, capture);
         pos.unmake_move();
 
         move_stats.emplace_back(m, current);
@@ -89,7 +96,7 @@ void perft_divide(Board& pos, int depth, bool verify) {
     cout << string(96, '-') << "\n";
 
     for (const auto& [move, stats] : move_stats) {
-        cout << left << setw(8) << move.to_string() << right 
+        cout << left << setw(8) << move.to_uci() << right 
              << setw(12) << stats.nodes
              << setw(12) << stats.captures
              << setw(12) << stats.enpassants
@@ -110,7 +117,7 @@ void perft_divide(Board& pos, int depth, bool verify) {
 
     // Verification against known positions
     if (verify) {
-        const string fen = pos.get_fen();
+        const string fen = pos.to_fen();
         if (fen == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") {
             const uint64_t expected[] = {1, 20, 400, 8902, 197281, 4865609};
             if (depth <= 6 && total.nodes != expected[depth]) {
@@ -143,6 +150,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Initialize board
+    Magic::init();
     Board pos;
     if (!pos.set_fen(fen)) {
         cerr << "Invalid FEN: " << fen << "\n";
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include "../src/board.h"
+#include "../src/thread.h"
+#include "../src/magic.h"
+
+using namespace std;
+
+// Every heap allocation in the process goes through here
+static atomic<uint64_t> allocations{0};
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// A fixed-depth search may allocate once per worker and iteration, for the
+// PV it keeps; everything else (threads, tables, stacks) exists beforehand
+static bool search_allocations(const char* fen, int depth, size_t threads, SmpMode mode) {
+    Board pos;
+    pos.set_fen(fen);
+    TT.clear();
+    Threads.set(threads);
+    Threads.set_mode(mode);
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.printInfo = false;
+
+    const uint64_t before = allocations.load();
+    Threads.start_thinking(pos, limits);
+    Threads.wait_for_search_finished();
+    const uint64_t allocated = allocations.load() - before;
+    const uint64_t budget = uint64_t(depth) * threads;
+
+    cout << smp_mode_name(mode) << ", " << threads << " thread(s): " << allocated
+         << " allocations, at most " << budget << "\n";
+    if (allocated > budget || !Threads.result().bestMove.is_valid()) {
+        cerr << "Allocation test: FAIL (" << fen << ")" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    Magic::init();
+    TT.resize(16);
+
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    };
+
+    for (const char* fen : fens)
+        if (!search_allocations(fen, 8, 1, SmpMode::LAZY)
+            || !search_allocations(fen, 8, 4, SmpMode::LAZY)
+            || !search_allocations(fen, 8, 4, SmpMode::ABDADA))
+            return 1;
+    Threads.set(0);
+
+    cout << "Allocation test: PASS" << endl;
+    return 0;
+}
@@ -1,29 +1,83 @@
 #include <iostream>
+#include <sstream>
+#include <string>
 #include "../src/board.h"
 #include "../src/move.h"
+#include "../src/movegen.h"
+#include "../src/magic.h"
 
 int main() {
+    Magic::init();
     Board b;
-    b.set_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    b.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
     std::cout << "=== Test: Board FEN Load ===" << std::endl;
     b.print();
 
-    if (b.sideToMove != WHITE) {
+    if (b.side_to_move() != WHITE) {
         std::cerr << "Error: Side to move should be WHITE." << std::endl;
         return 1;
     }
 
     Move m = Move(12, 28); // e2 -> e4
-    b.make_move(m);
+    StateInfo st;
+    b.make_move(m, st);
 
-    if (b.pieces[WHITE][PAWN] & (1ULL << 28)) {
+    if (b.pieces(WHITE, PAWN) & (1ULL << 28)) {
         std::cout << "Move generation: PASS" << std::endl;
     } else {
         std::cerr << "Move generation: FAIL" << std::endl;
         return 1;
     }
 
+    const Key startKey = Board().key();
+    b.unmake_move();
+    if (b.key() != startKey || !(b.pieces(WHITE, PAWN) & (1ULL << 12))) {
+        std::cerr << "Unmake: FAIL" << std::endl;
+        return 1;
+    }
+
+    // Ng1-f3 Ng8-f6 Nf3-g1: White can now close a cycle, and one more
+    // knight shuffle repeats the start position.
+    StateInfo hist[4];
+    b.make_move(Move(6, 21), hist[0]);
+    b.make_move(Move(62, 45), hist[1]);
+    b.make_move(Move(21, 6), hist[2]);
+    if (!b.has_game_cycle(10) || b.is_repetition(10)) {
+        std::cerr << "Game cycle: FAIL" << std::endl;
+        return 1;
+    }
+    b.make_move(Move(45, 62), hist[3]);
+    if (!b.is_repetition(10) || b.is_repetition(0)) {
+        std::cerr << "Repetition: FAIL" << std::endl;
+        return 1;
+    }
+
+    // Keys are Polyglot's: the test sequences of the book format spec
+    struct { const char* moves; Key key; } polyglot[] = {
+        { "", 0x463B96181691FC9CULL },
+        { "e2e4", 0x823C9B50FD114196ULL },
+        { "e2e4 d7d5", 0x0756B94461C50FB0ULL },
+        { "e2e4 d7d5 e4e5", 0x662FAFB965DB29D4ULL },
+        { "e2e4 d7d5 e4e5 f7f5", 0x22A48B5A8E47FF78ULL },
+        { "e2e4 d7d5 e4e5 f7f5 e1e2", 0x652A607CA3F242C1ULL },
+        { "e2e4 d7d5 e4e5 f7f5 e1e2 e8f7", 0x00FDD303C946BDD9ULL },
+        { "a2a4 b7b5 h2h4 b5b4 c2c4", 0x3C8123EA7B067637ULL },
+        { "a2a4 b7b5 h2h4 b5b4 c2c4 b4c3 a1a3", 0x5C3F9B829B279560ULL },
+    };
+    for (const auto& test : polyglot) {
+        Board pos;
+        StateInfo states[8];
+        std::istringstream moves(test.moves);
+        std::string uci;
+        for (int i = 0; moves >> uci; ++i)
+            pos.make_move(parse_move(pos, uci), states[i]);
+        if (pos.key() != test.key) {
+            std::cerr << "Polyglot key after \"" << test.moves << "\": FAIL" << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "Board test passed." << std::endl;
     return 0;
 }
@@ -7,7 +7,7 @@ int main() {
     Evaluation eval;
 
     std::cout << "=== Test: Evaluation Consistency ===" << std::endl;
-    b.set_from_fen("8/8/8/8/8/8/8/8 w - - 0 1");
+    b.set_fen("4k3/8/8/8/8/8/8/4K3 w - - 0 1");  // Bare kings: a board needs both
 
     int score1 = eval.evaluate(b);
     int score2 = eval.evaluate(b);
@@ -17,7 +17,7 @@ int main() {
         return 1;
     }
 
-    b.set_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    b.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     int openingScore = eval.evaluate(b);
     std::cout << "Opening position score: " << openingScore << std::endl;
 
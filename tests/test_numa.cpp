@@ -0,0 +1,175 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../src/util/numa.h"
+#include "../src/eval/nnue/replicas.h"
+#include "../src/thread.h"
+#include "../src/magic.h"
+
+static bool fail(const char* what) {
+    std::cerr << what << ": FAIL" << std::endl;
+    return false;
+}
+
+// Node of each of 'threads' threads
+static std::vector<size_t> assignment(const Numa::Topology& topo, size_t threads) {
+    std::vector<size_t> nodes;
+    for (size_t i = 0; i < threads; ++i)
+        nodes.push_back(topo.node_of(i, threads));
+    return nodes;
+}
+
+static bool test_parse() {
+    std::cout << "=== Test: Topology descriptions ===" << std::endl;
+
+    std::vector<int> cpus;
+    if (!Numa::parse_cpulist("0-3,8,10-11\n", cpus) || cpus != std::vector<int>{ 0, 1, 2, 3, 8, 10, 11 })
+        return fail("cpulist");
+    if (Numa::parse_cpulist("3-1", cpus) || Numa::parse_cpulist("1-x", cpus) || Numa::parse_cpulist("a", cpus))
+        return fail("Malformed cpulist");
+
+    Numa::Topology topo;
+    if (topo.nodes() != 1 || !topo.cpus())
+        return fail("Default topology");
+    if (!Numa::Topology::parse("0-3,8-11:4-7,12-15", topo) || topo.nodes() != 2 || topo.cpus() != 16
+        || topo.to_string() != "0-3,8-11:4-7,12-15")
+        return fail("Synthetic topology");
+    if (Numa::Topology::parse("0-3::4-7", topo) || Numa::Topology::parse("", topo) || topo.nodes() != 2)
+        return fail("Malformed topology");
+
+    std::cout << "Topology descriptions passed." << std::endl;
+    return true;
+}
+
+// A fake /sys/devices/system/node: node1 has no CPUs (memory only) and
+// node2's CPU is beyond any affinity mask
+static bool test_detect() {
+    std::cout << "=== Test: Topology detection ===" << std::endl;
+
+    const std::string root = "/tmp/test_numa_sysfs";
+    const char* lists[] = { "0", "", "100000" };
+    mkdir(root.c_str(), 0755);
+    for (int n = 0; n < 3; ++n) {
+        const std::string dir = root + "/node" + std::to_string(n);
+        mkdir(dir.c_str(), 0755);
+        std::ofstream(dir + "/cpulist") << lists[n] << "\n";
+    }
+    mkdir((root + "/power").c_str(), 0755);
+
+    const Numa::Topology topo = Numa::Topology::detect(root);
+    for (int n = 0; n < 3; ++n) {
+        const std::string dir = root + "/node" + std::to_string(n);
+        std::remove((dir + "/cpulist").c_str());
+        rmdir(dir.c_str());
+    }
+    rmdir((root + "/power").c_str());
+    rmdir(root.c_str());
+
+    if (topo.nodes() != 1 || topo.cpus_of(0) != std::vector<int>{ 0 })
+        return fail("Fake sysfs");
+    if (Numa::Topology::detect("/nonexistent").nodes() != 1)
+        return fail("Missing sysfs");
+
+    const Numa::Topology& sys = Numa::Topology::system();
+    std::cout << "This machine: " << sys.nodes() << " node(s), CPUs " << sys.to_string() << std::endl;
+    std::cout << "Topology detection passed." << std::endl;
+    return true;
+}
+
+static bool test_assignment() {
+    std::cout << "=== Test: Thread assignment ===" << std::endl;
+
+    Numa::Topology topo;
+    Numa::Topology::parse("0-3:4-7", topo);
+    if (assignment(topo, 3) != std::vector<size_t>{ 0, 0, 1 }
+        || assignment(topo, 2) != std::vector<size_t>{ 0, 1 }
+        || assignment(topo, 8) != std::vector<size_t>{ 0, 0, 0, 0, 1, 1, 1, 1 })
+        return fail("Two equal nodes");
+
+    // More threads than CPUs: still half each, in two groups
+    const std::vector<size_t> many = assignment(topo, 20);
+    for (size_t i = 0; i < many.size(); ++i)
+        if (many[i] != (i < 10 ? 0u : 1u))
+            return fail("Oversubscribed");
+
+    // Uneven nodes get threads in proportion to their CPUs
+    Numa::Topology::parse("0-5:6-7", topo);
+    if (assignment(topo, 4) != std::vector<size_t>{ 0, 0, 0, 1 })
+        return fail("Uneven nodes");
+
+    std::cout << "Thread assignment passed." << std::endl;
+    return true;
+}
+
+static bool test_replicas() {
+    std::cout << "=== Test: Network replicas ===" << std::endl;
+
+    auto net = std::make_unique<NNUE::Network>();
+    net->initialize();
+    net->output_bias = 1234;
+
+    Numa::Topology four;
+    Numa::Topology::parse("0:1:2:3", four);
+    {
+        NNUE::NetworkReplicas replicas(*net, four);
+        if (replicas.size() != 4)
+            return fail("Replica count");
+        for (size_t n = 0; n < 4; ++n) {
+            const NNUE::Network& r = replicas.on_node(n);
+            if (&r == net.get() || (n && &r == &replicas.on_node(n - 1))
+                || std::memcmp(&r, net.get(), sizeof(NNUE::Network)) != 0)
+                return fail("Replica contents");
+        }
+    }
+
+    NNUE::NetworkReplicas single(*net, Numa::Topology());
+    if (single.size() != 1 || &single.on_node(0) != net.get())
+        return fail("Single node shares the source");
+
+    // The pool spreads threads over the synthetic nodes and hands each
+    // worker its node's copy
+    Numa::Topology two;
+    Numa::Topology::parse("0-1:2-3", two);
+    Threads.set(4);
+    Threads.set_network(net.get());
+    Threads.set_topology(two);
+    const SearchWorker& main = Threads.main().worker();
+    if (Threads.size() != 4 || Threads.numa_topology().nodes() != 2 || main.numa_node() != 0
+        || !main.network() || main.network() == net.get() || main.network()->output_bias != 1234)
+        return fail("Pool replicas");
+    TT.clear(Threads.size(), Threads.numa_topology());
+
+    Board b;
+    b.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    SearchLimits limits;
+    limits.depth = 5;
+    limits.printInfo = false;
+    Threads.start_thinking(b, limits);
+    Threads.wait_for_search_finished();
+    if (!Threads.result().bestMove.is_valid())
+        return fail("Search on synthetic nodes");
+
+    Threads.set_network(nullptr);
+    if (Threads.main().worker().network())
+        return fail("Dropping the network");
+    Threads.set(0);
+
+    std::cout << "Network replicas passed." << std::endl;
+    return true;
+}
+
+int main() {
+    Magic::init();
+    TT.resize(16);
+
+    if (!test_parse() || !test_detect() || !test_assignment() || !test_replicas())
+        return 1;
+    std::cout << "NUMA test passed." << std::endl;
+    return 0;
+}
@@ -1,24 +1,121 @@
 #include <iostream>
 #include "../src/board.h"
-#include "../src/search.h"
+#include "../src/thread.h"
+#include "../src/magic.h"
 #include "../src/move.h"
 
-int main() {
+// Runs a fixed-depth search on 'threads' threads and returns the result
+static SearchResult think(const char* fen, int depth, size_t threads,
+                          SmpMode mode = SmpMode::LAZY) {
     Board b;
-    Search search;
+    b.set_fen(fen);
+    TT.clear();
+    Threads.set(threads);
+    Threads.set_mode(mode);
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.printInfo = false;
+    Threads.start_thinking(b, limits);
+    Threads.wait_for_search_finished();
+    return Threads.result();
+}
+
+int main() {
+    Magic::init();
+    TT.resize(16);
 
     std::cout << "=== Test: Search Function ===" << std::endl;
-    b.set_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
-    SearchResult result = search.iterative_deepening(b, 3);
-    std::cout << "Best move: " << result.bestMove.to_string() 
+    const char* start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    SearchResult result = think(start, 5, 1);
+    std::cout << "Best move: " << result.bestMove.to_uci()
               << " | Score: " << result.score << std::endl;
 
-    if (!result.bestMove.is_ok()) {
+    Board b;
+    b.set_fen(start);
+    if (!result.bestMove.is_valid() || !b.pseudo_legal(result.bestMove) || result.depth != 5) {
         std::cerr << "Search failed to return a move." << std::endl;
         return 1;
     }
 
+    // Mate in one (Qxf7#), found by every thread count; the helpers' votes
+    // must not overrule the mate
+    const char* mate = "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4";
+    for (size_t threads : { 1, 2, 4 }) {
+        result = think(mate, 6, threads);
+        if (result.bestMove.to_uci() != "h5f7" || result.score != Search::VALUE_MATE - 1) {
+            std::cerr << "Mate in one with " << threads << " threads: FAIL ("
+                      << result.bestMove.to_uci() << " " << result.score << ")" << std::endl;
+            return 1;
+        }
+    }
+
+    // Perpetual check: three rooks down, White draws with Qe8+ Kh7 Qh5+.
+    // Game-cycle detection scores the shuffle as a draw from depth 5; with
+    // repetitions alone it takes depth 10
+    result = think("6k1/rrr3p1/8/7Q/8/8/8/7K w - - 0 1", 6, 1);
+    if (result.bestMove.to_uci() != "h5e8" || result.score != Search::VALUE_DRAW) {
+        std::cerr << "Perpetual check: FAIL (" << result.bestMove.to_uci() << " "
+                  << result.score << ")" << std::endl;
+        return 1;
+    }
+
+    // ABDADA finds the same mate
+    for (size_t threads : { 1, 4 }) {
+        result = think(mate, 6, threads, SmpMode::ABDADA);
+        if (result.bestMove.to_uci() != "h5f7" || result.score != Search::VALUE_MATE - 1) {
+            std::cerr << "ABDADA mate in one with " << threads << " threads: FAIL ("
+                      << result.bestMove.to_uci() << " " << result.score << ")" << std::endl;
+            return 1;
+        }
+    }
+    result = think(start, 7, 4, SmpMode::ABDADA);
+    if (!b.pseudo_legal(result.bestMove) || result.depth != 7) {
+        std::cerr << "ABDADA search: FAIL" << std::endl;
+        return 1;
+    }
+
+    // Markers: one owner per (position, move), gone once unmarked
+    static SearchingTable searching;
+    const Move e4 = Move::from_uci("e2e4");
+    if (!searching.mark(b.key(), e4) || searching.mark(b.key(), e4)
+        || !searching.contains(b.key(), e4) || searching.contains(b.key(), Move::from_uci("d2d4"))) {
+        std::cerr << "Searching markers: FAIL" << std::endl;
+        return 1;
+    }
+    searching.unmark(b.key(), e4);
+    if (searching.contains(b.key(), e4)) {
+        std::cerr << "Searching markers: FAIL" << std::endl;
+        return 1;
+    }
+
+    SmpMode mode;
+    if (!parse_smp_mode("abdada", mode) || mode != SmpMode::ABDADA
+        || parse_smp_mode("ybwc", mode) || std::string(smp_mode_name(SmpMode::LAZY)) != "lazy") {
+        std::cerr << "SMP mode names: FAIL" << std::endl;
+        return 1;
+    }
+    Threads.set_mode(SmpMode::LAZY);
+
+    // Helpers search too: all threads count nodes, and stop() ends an
+    // infinite search
+    Threads.set(3);
+    b.set_fen(start);
+    SearchLimits limits;
+    limits.infinite = true;
+    limits.printInfo = false;
+    Threads.start_thinking(b, limits);
+    while (Threads.nodes_searched() < 200000)
+        std::this_thread::yield();
+    Threads.stop();
+    Threads.wait_for_search_finished();
+    if (!Threads.result().bestMove.is_valid()) {
+        std::cerr << "Infinite search: FAIL" << std::endl;
+        return 1;
+    }
+    Threads.set(0);
+
     std::cout << "Search test passed." << std::endl;
     return 0;
 }
@@ -0,0 +1,43 @@
+#include <iostream>
+#include "../src/board.h"
+#include "../src/movegen.h"
+#include "../src/magic.h"
+#include "../src/see.h"
+
+struct SeeCase {
+    const char* fen;
+    const char* move;
+    int expected;
+};
+
+int main() {
+    Magic::init();
+
+    std::cout << "=== Test: Static Exchange Evaluation ===" << std::endl;
+
+    const SeeCase cases[] = {
+        // Rook takes a pawn defended only by a rook that is itself undefended
+        { "1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5", 100 },
+        // Knight takes a pawn; the x-rayed queen and rook keep the exchange going
+        { "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5", -220 },
+        // Undefended queen
+        { "4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1", "d1d5", 900 },
+    };
+
+    for (const SeeCase& c : cases) {
+        Board b;
+        b.set_fen(c.fen);
+        const Move m = parse_move(b, c.move);
+        const int value = SEE::see(b, m);
+
+        if (value != c.expected
+            || !SEE::see_ge(b, m, c.expected) || SEE::see_ge(b, m, c.expected + 1)) {
+            std::cerr << "SEE: FAIL " << c.move << " = " << value
+                      << ", expected " << c.expected << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "SEE test passed." << std::endl;
+    return 0;
+}
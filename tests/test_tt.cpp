@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include "../src/tt.h"
+
+int main() {
+    std::cout << "=== Test: Transposition Table ===" << std::endl;
+
+    TranspositionTable tt;
+    tt.resize(1);
+
+    // Round trip, including the static eval slot and the ttPv flag
+    const Key key = 0x9D39247E33776D41ULL;
+    const Move move(12, 28);
+    tt.store(key, move, 35, -12, BOUND_LOWER, 9, true);
+
+    TTData e;
+    bool found = tt.probe(key, e);
+    if (!found || e.move != move || e.value != 35 || e.eval != -12
+        || e.bound != BOUND_LOWER || e.depth != 9 || !e.isPv) {
+        std::cerr << "Round trip: FAIL" << std::endl;
+        return 1;
+    }
+
+    // A shallower non-exact result for the same position keeps the deeper one
+    tt.store(key, Move::none(), 50, -12, BOUND_UPPER, 2, false);
+    found = tt.probe(key, e);
+    if (!found || e.depth != 9 || e.move != move) {
+        std::cerr << "Depth preference: FAIL" << std::endl;
+        return 1;
+    }
+
+    // In the next search the old entry is stale and gets overwritten
+    tt.newGeneration();
+    tt.store(key, Move::none(), 50, -12, BOUND_UPPER, 2, false);
+    found = tt.probe(key, e);
+    if (!found || e.depth != 2 || e.move != move || e.bound != BOUND_UPPER) {
+        std::cerr << "Aging: FAIL" << std::endl;
+        return 1;
+    }
+
+    // Any key lands in range, whatever the table size
+    tt.resize(3);
+    for (Key k = 1; k; k <<= 1)
+        tt.store(k | 1, move, 0, 0, BOUND_EXACT, 1, false);
+    if (tt.hashfull() < 0 || tt.hashfull() > 1000) {
+        std::cerr << "Hashfull: FAIL" << std::endl;
+        return 1;
+    }
+
+    // Growing with rehash keeps every entry reachable
+    tt.resize(1);
+    Key k = 0x12345678ABCDEFULL;
+    for (int i = 0; i < 1000; ++i, k = k * 6364136223846793005ULL + 1442695040888963407ULL)
+        tt.store(k, Move(uint16_t(k | 1)), i, 0, BOUND_EXACT, 5, false);
+    tt.rehash(4, 2);
+    k = 0x12345678ABCDEFULL;
+    for (int i = 0; i < 1000; ++i, k = k * 6364136223846793005ULL + 1442695040888963407ULL)
+        if (!tt.probe(k, e) || e.move != Move(uint16_t(k | 1)) || e.depth != 5) {
+            std::cerr << "Rehash: FAIL" << std::endl;
+            return 1;
+        }
+
+    // Snapshot round trip: the loaded table is the file, mapped in place
+    const char* snapshot = "test_tt_snapshot.bin";
+    TranspositionTable copy;
+    if (!tt.save(snapshot) || !copy.load(snapshot) || copy.size() != tt.size()
+        || !copy.probe(0x12345678ABCDEFULL, e) || e.depth != 5) {
+        std::cerr << "Snapshot: FAIL" << std::endl;
+        std::remove(snapshot);
+        return 1;
+    }
+    std::remove(snapshot);
+
+    // Telemetry: counts from every thread, split by node type and reason
+    TranspositionTable counted;
+    counted.resize(1);
+    counted.enable_stats(true);
+    counted.store(key, move, 35, -12, BOUND_LOWER, 9, false);        // Empty slot
+    counted.store(key, Move::none(), 50, -12, BOUND_UPPER, 2, false);  // Kept the deeper one
+    counted.probe(key, e, TTNode::PV);
+    counted.count_cutoff(TTNode::PV);
+    std::thread([&] { counted.probe(~key, e, TTNode::QSEARCH); }).join();
+
+    const TTStats s = counted.stats(2);
+    if (s.probes[int(TTNode::PV)] != 1 || s.hits[int(TTNode::PV)] != 1
+        || s.cutoffs[int(TTNode::PV)] != 1 || s.probes[int(TTNode::QSEARCH)] != 1
+        || s.hits[int(TTNode::QSEARCH)] != 0
+        || s.replacements[int(TTReplace::EMPTY)] != 1
+        || s.replacements[int(TTReplace::SAME_KEY_KEPT)] != 1
+        || s.used != 1 || s.depth[9 - DEPTH_UNSEARCHED] != 1 || s.age[0] != 1
+        || counted.stats_json().rfind("{\"probes\":{\"pv\":1,", 0) != 0) {
+        std::cerr << "Telemetry: FAIL" << std::endl;
+        return 1;
+    }
+
+    std::cout << "TT test passed." << std::endl;
+    return 0;
+}
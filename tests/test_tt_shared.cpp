@@ -0,0 +1,152 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/tt.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Same self-checking payload as the stress test: every field is a function
+// of the low 16 key bits, so a torn cross-process read shows up as a mismatch
+static bool consistent(Key key, const TTData& d) {
+    const uint16_t k = static_cast<uint16_t>(key);
+    const int value = int(k % 20000) - 10000;
+    return d.move == Move(uint16_t(k ^ 0x5A5A)) && d.value == value && d.eval == -value / 2
+        && d.depth == 1 + k % 60 && d.bound == Bound(1 + k % 3) && d.isPv == bool(k & 1);
+}
+
+static void store(TranspositionTable& tt, Key key) {
+    const uint16_t k = static_cast<uint16_t>(key);
+    const int value = int(k % 20000) - 10000;
+    tt.store(key, Move(uint16_t(k ^ 0x5A5A)), value, -value / 2, Bound(1 + k % 3), 1 + k % 60, k & 1);
+}
+
+// Keys owned by process 'idx'
+static std::vector<Key> keys_of(int idx, int count) {
+    std::vector<Key> keys(count);
+    std::mt19937_64 rng(1000 + idx);
+    for (Key& k : keys)
+        k = rng();
+    return keys;
+}
+
+// Attaches, writes its own keys while probing everyone's, then reports
+// through the exit status: 0 ok, 1 attach failed, 2 torn read, 3 own key lost
+static int child(const std::string& name, int idx, int processes, int keysEach) {
+    TranspositionTable tt;
+    if (!tt.attach_shared(name, 1))
+        return 1;
+
+    std::vector<std::vector<Key>> all;
+    for (int p = 0; p < processes; ++p)
+        all.push_back(keys_of(p, keysEach));
+
+    std::mt19937_64 rng(idx);
+    for (int round = 0; round < 50; ++round)
+        for (int i = 0; i < keysEach; ++i) {
+            store(tt, all[idx][i]);
+            const Key other = all[rng() % processes][rng() % keysEach];
+            TTData d;
+            if (tt.probe(other, d) && !consistent(other, d))
+                return 2;
+        }
+
+    int found = 0;
+    for (Key k : all[idx]) {
+        TTData d;
+        found += tt.probe(k, d);
+    }
+    // Every process starts a search; only the first advances the epoch
+    tt.newGeneration();
+    tt.detach_shared();
+    return found * 100 >= keysEach * 99 ? 0 : 3;
+}
+
+int main() {
+    std::cout << "=== Test: Shared TT across processes ===" << std::endl;
+
+    const std::string name = "/tt_test_" + std::to_string(getpid());
+    const int processes = 4, keysEach = 2000;
+
+    TranspositionTable tt;
+    if (!tt.attach_shared(name, 16) || !tt.is_shared()) {
+        std::cerr << "Create: FAIL" << std::endl;
+        return 1;
+    }
+    const uint8_t startGeneration = tt.generation();
+
+    std::vector<pid_t> children;
+    for (int idx = 0; idx < processes; ++idx) {
+        const pid_t pid = fork();
+        if (pid == 0)
+            _exit(child(name, idx, processes, keysEach));
+        children.push_back(pid);
+    }
+
+    bool ok = true;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+            std::cerr << "Child " << pid << " exited with " << WEXITSTATUS(status) << std::endl;
+            ok = false;
+        }
+    }
+
+    // Writes of the children are visible here, and the epoch one of them
+    // advanced; starting another search within the epoch keeps it
+    tt.newGeneration();
+    int found = 0;
+    for (int idx = 0; idx < processes; ++idx)
+        for (Key k : keys_of(idx, keysEach)) {
+            TTData d;
+            found += tt.probe(k, d) && consistent(k, d);
+        }
+    if (!ok || found * 100 < processes * keysEach * 99
+        || tt.generation() != uint8_t(startGeneration + GENERATION_DELTA)) {
+        std::cerr << "Shared store/probe: FAIL (" << found << " found)" << std::endl;
+        tt.detach_shared();
+        return 1;
+    }
+
+    // A process that dies attached does not keep the segment alive: the last
+    // live process to detach removes it
+    pid_t crashed = fork();
+    if (crashed == 0) {
+        TranspositionTable other;
+        _exit(other.attach_shared(name, 1) ? 0 : 1);  // No detach, no destructor
+    }
+    waitpid(crashed, nullptr, 0);
+    tt.detach_shared();
+    if (tt.is_shared() || TranspositionTable::remove_stale_shared(name)) {
+        std::cerr << "Detach cleanup: FAIL" << std::endl;
+        return 1;
+    }
+
+    // A segment left only by dead processes is stale and can be removed
+    crashed = fork();
+    if (crashed == 0) {
+        TranspositionTable other;
+        _exit(other.attach_shared(name, 1) ? 0 : 1);
+    }
+    waitpid(crashed, nullptr, 0);
+    if (!TranspositionTable::remove_stale_shared(name)) {
+        std::cerr << "Stale cleanup: FAIL" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Shared TT test passed." << std::endl;
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cout << "=== Test: Shared TT across processes ===" << std::endl;
+    std::cout << "POSIX shared memory not available, skipped." << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../src/tt.h"
+
+// Every field written for a key is a function of its low 16 bits (the part
+// the table checks), so any probe hit whose fields disagree with each other
+// was assembled from two different writes.
+struct Expected {
+    Move  move;
+    int   value;
+    int   eval;
+    int   depth;
+    Bound bound;
+    bool  pv;
+
+    explicit Expected(Key key) {
+        const uint16_t k = static_cast<uint16_t>(key);
+        move  = Move(uint16_t(k ^ 0x5A5A));
+        value = int(k % 20000) - 10000;
+        eval  = -value / 2;
+        depth = 1 + k % 60;
+        bound = Bound(1 + k % 3);
+        pv    = k & 1;
+    }
+
+    bool matches(const TTData& d) const {
+        return d.move == move && d.value == value && d.eval == eval
+            && d.depth == depth && d.bound == bound && d.isPv == pv;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 2000000;
+    const int threads = std::clamp(int(std::thread::hardware_concurrency()), 2, 8);
+
+    std::cout << "=== Test: TT stress, " << threads << " threads ===" << std::endl;
+
+    // A small table and a key pool much larger than it: constant overwrites
+    TranspositionTable tt;
+    tt.resize(1);
+
+    std::vector<Key> keys(1 << 18);
+    std::mt19937_64 rng(20250803);
+    for (Key& k : keys)
+        k = rng();
+
+    std::atomic<uint64_t> hits{0}, torn{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] {
+            std::mt19937_64 local(t + 1);
+            uint64_t h = 0, bad = 0;
+            for (int i = 0; i < iterations; ++i) {
+                const Key key = keys[local() & (keys.size() - 1)];
+                const Expected e(key);
+                if (local() & 1) {
+                    tt.store(key, e.move, e.value, e.eval, e.bound, e.depth, e.pv);
+                } else {
+                    TTData d;
+                    if (tt.probe(key, d)) {
+                        ++h;
+                        bad += !e.matches(d);
+                    }
+                }
+            }
+            hits += h;
+            torn += bad;
+        });
+
+    for (std::thread& w : workers)
+        w.join();
+
+    std::cout << "Hits: " << hits << ", inconsistent: " << torn << std::endl;
+    if (!hits || torn) {
+        std::cerr << "TT stress: FAIL" << std::endl;
+        return 1;
+    }
+
+    std::cout << "TT stress test passed." << std::endl;
+    return 0;
+}